@@ -5,17 +5,35 @@
 #ifndef MMPPT_TOY_QT_VTK_EX005_ALIASES_HPP_
 #define MMPPT_TOY_QT_VTK_EX005_ALIASES_HPP_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
 /**
- * A function that will produce a hash for an array of 4 values.
+ * Combine the hashes of the values in an array in order, so that
+ * permutations of the same values hash differently.
+ */
+template<size_t N>
+inline std::size_t
+hash_array(const std::array<size_t, N> &arr) {
+  std::hash<size_t> size_t_hash;
+  std::size_t seed = 0;
+  for (size_t value : arr) {
+    seed ^= size_t_hash(value) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+/**
+ * A function that will produce a hash for an array of 3 values.
  */
 struct tri_hasher {
 
   std::size_t operator()(const std::array<size_t, 3> &arr) const {
-    std::hash<size_t> size_t_hash;
-    return size_t_hash(arr[0]) ^ size_t_hash(arr[1]) ^ size_t_hash(arr[2]);
+    return hash_array(arr);
   }
 
 };
@@ -26,8 +44,7 @@ struct tri_hasher {
 struct edge_hasher {
 
   std::size_t operator()(const std::array<size_t, 2> &arr) const {
-    std::hash<size_t> size_t_hash;
-    return size_t_hash(arr[0]) ^ size_t_hash(arr[1]);
+    return hash_array(arr);
   }
 
 };
@@ -44,8 +61,12 @@ typedef std::vector<size_t> vi_list;
 // Vertex to vertices map.
 typedef std::unordered_map<size_t, vi_list> v_to_vs_list;
 
+// Edge, with a given vertex index type.
+template<typename Index>
+using basic_edge = std::array<Index, 2>;
+
 // Edge.
-typedef std::array<size_t, 2> edge;
+typedef basic_edge<size_t> edge;
 
 // Edge list.
 typedef std::vector<edge> edge_list;
@@ -53,8 +74,12 @@ typedef std::vector<edge> edge_list;
 // Edge index list.
 typedef std::vector<size_t> edgei_list;
 
+// Triangle, with a given vertex index type.
+template<typename Index>
+using basic_tri = std::array<Index, 3>;
+
 // Triangle.
-typedef std::array<size_t, 3> tri;
+typedef basic_tri<size_t> tri;
 
 // Triangle list.
 typedef std::vector<tri> tri_list;
@@ -62,32 +87,45 @@ typedef std::vector<tri> tri_list;
 // Triangle index list.
 typedef std::vector<size_t> trii_list;
 
+// Tetrahedron, with a given vertex index type.
+template<typename Index>
+using basic_tet = std::array<Index, 4>;
+
+// Tetrahedron list, with a given vertex index type.
+template<typename Index>
+using basic_tet_list = std::vector<basic_tet<Index>>;
+
 // Tetrahedron.
-typedef std::array<size_t, 4> tet;
+typedef basic_tet<size_t> tet;
 
 // Tetrahedron list.
-typedef std::vector<tet> tet_list;
+typedef basic_tet_list<size_t> tet_list;
+
+// Tetrahedron with 32 bit vertex indices.
+typedef basic_tet<uint32_t> tet32;
+
+// Tetrahedron list with 32 bit vertex indices.
+typedef basic_tet_list<uint32_t> tet32_list;
 
 // Tetrahedron index list.
 typedef std::vector<size_t> teti_list;
 
-// Tetrahedron to tetrahedrons map.
-typedef std::unordered_map<size_t, teti_list> tet_to_tets_map;
-
 // Sub-mesh index list.
 typedef std::vector<size_t> sm_list;
 
-// Sorted triangle to tets map.
-typedef std::unordered_map<tri, teti_list, tri_hasher> stri_to_tets_map;
-
-// Sorted edge to tets map.
-typedef std::unordered_map<edge, edgei_list, edge_hasher> sedge_to_tets_map;
-
 // Sorted triangle to triangle map.
 typedef std::unordered_map<tri, tri, tri_hasher> stri_to_tri_map;
 
+// Field scalar, field vectors are stored in single precision when built with
+// MMPPT_SINGLE_PRECISION_FIELDS. Vertex coordinates are always doubles.
+#ifdef MMPPT_SINGLE_PRECISION_FIELDS
+typedef float field_scalar;
+#else
+typedef double field_scalar;
+#endif
+
 // Field vector.
-typedef std::array<double, 3> fv;
+typedef std::array<field_scalar, 3> fv;
 
 // Field.
 typedef std::vector<fv> fv_list;
@@ -0,0 +1,283 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "load_tecplot.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include "tecplot_generator.hpp"
+#include "tecplot_scanner.hpp"
+
+/**
+ * Loader throughput benchmark, generates a synthetic tecplot file (or uses
+ * an existing one), reads it with TecplotFileLoader a number of times and
+ * reports throughput, peak memory and the time spent in each phase of the
+ * read.
+ *
+ * usage: mmppt-loader-bench [options]
+ */
+
+namespace {
+
+using seconds = std::chrono::duration<double>;
+
+struct Options {
+  TecplotGenerator::Parameters parameters;
+  std::string file_name;
+  bool keep{false};
+  size_t repeat{5};
+  size_t n_threads{0};
+  TecplotFileLoader::ReadMode mode{TecplotFileLoader::ReadMode::Automatic};
+};
+
+void
+usage(const char *exe) {
+
+  std::cerr
+      << "usage: " << exe << " [options]\n"
+      << "  --verts N        number of vertices (default 100000)\n"
+      << "  --tets N         number of tetrahedra (default 400000)\n"
+      << "  --zones N        number of zones (default 10)\n"
+      << "  --format F       number format: scientific, fixed or shortest (default scientific)\n"
+      << "  --precision N    digits after the decimal point, 0-17 (default 12)\n"
+      << "  --per-line N     values per line (default 5)\n"
+      << "  --seed N         random seed (default 1)\n"
+      << "  --file PATH      benchmark an existing file instead of generating one\n"
+      << "  --keep           keep the generated file\n"
+      << "  --repeat N       number of timed reads (default 5)\n"
+      << "  --threads N      loader threads, 0 means one per core (default 0)\n"
+      << "  --mode M         read mode: automatic, mapped or stream (default automatic)\n";
+
+}
+
+Options
+parse_options(int argc, char *argv[]) {
+
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+
+    std::string_view arg{argv[i]};
+
+    if (arg == "--keep") {
+      options.keep = true;
+      continue;
+    }
+
+    if (i + 1 >= argc) throw std::invalid_argument("Missing value for '" + std::string(arg) + "'.");
+    std::string value{argv[++i]};
+
+    if (arg == "--verts") {
+      options.parameters.n_verts = std::stoull(value);
+    } else if (arg == "--tets") {
+      options.parameters.n_elems = std::stoull(value);
+    } else if (arg == "--zones") {
+      options.parameters.n_zones = std::stoull(value);
+    } else if (arg == "--format") {
+      if (value == "scientific") {
+        options.parameters.number_format = TecplotGenerator::NumberFormat::Scientific;
+      } else if (value == "fixed") {
+        options.parameters.number_format = TecplotGenerator::NumberFormat::Fixed;
+      } else if (value == "shortest") {
+        options.parameters.number_format = TecplotGenerator::NumberFormat::Shortest;
+      } else {
+        throw std::invalid_argument("Unknown number format '" + value + "'.");
+      }
+    } else if (arg == "--precision") {
+      options.parameters.precision = std::stoi(value);
+      if (options.parameters.precision < 0 || options.parameters.precision > TecplotGenerator::max_precision) {
+        throw std::invalid_argument("The precision must be between 0 and "
+                                        + std::to_string(TecplotGenerator::max_precision) + ".");
+      }
+    } else if (arg == "--per-line") {
+      options.parameters.values_per_line = std::stoull(value);
+    } else if (arg == "--seed") {
+      options.parameters.seed = std::stoull(value);
+    } else if (arg == "--file") {
+      options.file_name = value;
+    } else if (arg == "--repeat") {
+      options.repeat = std::max<size_t>(std::stoull(value), 1);
+    } else if (arg == "--threads") {
+      options.n_threads = std::stoull(value);
+    } else if (arg == "--mode") {
+      if (value == "automatic") {
+        options.mode = TecplotFileLoader::ReadMode::Automatic;
+      } else if (value == "mapped") {
+        options.mode = TecplotFileLoader::ReadMode::Mapped;
+      } else if (value == "stream") {
+        options.mode = TecplotFileLoader::ReadMode::Stream;
+      } else {
+        throw std::invalid_argument("Unknown read mode '" + value + "'.");
+      }
+    } else {
+      throw std::invalid_argument("Unknown option '" + std::string(arg) + "'.");
+    }
+
+  }
+
+  return options;
+
+}
+
+/**
+ * Retrieve the peak resident set size of this process.
+ * @return the peak resident set size in MiB.
+ */
+double
+peak_rss_mib() {
+
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+
+  // Linux reports kilobytes.
+  return (double) usage.ru_maxrss / 1024.0;
+
+}
+
+/**
+ * Time a pass over a mapped file that splits and classifies lines, without
+ * converting any numbers. Zones are scanned concurrently, like the loader.
+ * @param file_name the name of the file.
+ * @param n_threads the number of threads.
+ * @return the time taken.
+ */
+seconds
+time_line_scan(const std::string &file_name, size_t n_threads) {
+
+  MappedFile mapped_file{file_name};
+  if (!mapped_file.is_mapped()) return seconds{0};
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  std::string_view prelude;
+  auto zones = TecplotScanner::find_zones(mapped_file.view(), prelude);
+
+  std::vector<size_t> n_lines(zones.size(), 0);
+  parallel_for(zones.size(), [&zones, &n_lines](size_t zone_idx) {
+    TecplotScanner::for_each_line(zones[zone_idx].body, [&](std::string_view line) {
+      TecplotScanner::ZoneHeader header{};
+      if (TecplotScanner::classify(line, header) != TecplotScanner::LineType::Other) {
+        n_lines[zone_idx]++;
+      }
+    });
+  }, n_threads);
+
+  auto stop = std::chrono::high_resolution_clock::now();
+
+  // Keep the pass from being optimised away.
+  size_t total = 0;
+  for (auto n : n_lines) total += n;
+  if (total == 0) std::cerr << "Warning: no data lines found." << std::endl;
+
+  return stop - start;
+
+}
+
+}
+
+int main(int argc, char *argv[]) {
+
+  Options options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  bool generated = options.file_name.empty();
+
+  try {
+
+    if (generated) {
+      options.file_name =
+          (std::filesystem::temp_directory_path() / "mmppt-loader-bench.tec").string();
+
+      std::cout << "Generating " << options.file_name << " ... " << std::flush;
+      auto start = std::chrono::high_resolution_clock::now();
+      TecplotGenerator::write(options.file_name, options.parameters);
+      auto stop = std::chrono::high_resolution_clock::now();
+      std::cout << seconds(stop - start).count() << " s" << std::endl;
+    }
+
+    double file_mib = (double) std::filesystem::file_size(options.file_name) / (1024.0 * 1024.0);
+    double rss_before = peak_rss_mib();
+
+    // One untimed read warms the page cache.
+    size_t n_verts, n_elems, n_zones;
+    {
+      Model warm_up = TecplotFileLoader::read(options.file_name, options.mode, options.n_threads);
+      n_verts = warm_up.mesh().vcl().size();
+      n_elems = warm_up.mesh().til().size();
+      n_zones = warm_up.field_list().n_fields();
+    }
+    double n_values = (double) (3 * n_verts + 3 * n_verts * n_zones + 5 * n_elems);
+
+    std::vector<TecplotFileLoader::Timings> timings(options.repeat);
+    std::vector<seconds> totals(options.repeat);
+    std::vector<seconds> line_scans(options.repeat);
+
+    for (size_t r = 0; r < options.repeat; ++r) {
+      auto start = std::chrono::high_resolution_clock::now();
+      Model model = TecplotFileLoader::read(
+          options.file_name, options.mode, options.n_threads, nullptr, &timings[r]);
+      totals[r] = std::chrono::high_resolution_clock::now() - start;
+      line_scans[r] = time_line_scan(options.file_name, options.n_threads);
+    }
+
+    // Report the fastest run, it is the least disturbed by the rest of the
+    // system.
+    size_t best = std::min_element(totals.begin(), totals.end()) - totals.begin();
+    const auto &t = timings[best];
+
+    double total = totals[best].count();
+    double parse = seconds(t.parse).count();
+    double scan = std::min(seconds(line_scans[best]).count(), parse);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\n";
+    std::cout << "File:         " << options.file_name << "\n";
+    std::cout << "Size:         " << file_mib << " MiB\n";
+    std::cout << "Model:        " << n_verts << " vertices, " << n_elems << " tetrahedra, "
+              << n_zones << " zones\n";
+    std::cout << "Field type:   " << (sizeof(field_scalar) == sizeof(float) ? "float32" : "float64") << "\n";
+    std::cout << "Threads:      " << thread_count(options.n_threads) << "\n";
+    std::cout << "Runs:         " << options.repeat << " (best reported)\n";
+    std::cout << "\n";
+    std::cout << "Total:        " << total << " s\n";
+    std::cout << "Throughput:   " << file_mib / total << " MB/s, "
+              << n_values / total / 1.0e6 << " M values/s\n";
+    std::cout << "Peak RSS:     " << peak_rss_mib() << " MiB (" << rss_before
+              << " MiB before reading, includes the mapped file)\n";
+    std::cout << "\n";
+    std::cout << "Open:         " << seconds(t.open).count() << " s\n";
+    std::cout << "Zone scan:    " << seconds(t.zone_scan).count() << " s\n";
+    std::cout << "Line scan:    " << scan << " s (estimated from a scan only pass)\n";
+    std::cout << "Conversion:   " << parse - scan << " s\n";
+    std::cout << "Validation:   " << seconds(t.validation).count() << " s\n";
+    std::cout << "Construction: " << seconds(t.construction).count() << " s\n";
+
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    if (generated && !options.keep) std::filesystem::remove(options.file_name);
+    return EXIT_FAILURE;
+  }
+
+  if (generated && !options.keep) std::filesystem::remove(options.file_name);
+
+  return EXIT_SUCCESS;
+
+}
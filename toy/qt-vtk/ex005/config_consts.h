@@ -11,6 +11,7 @@
 #define CONFIG_CURRENT_IMAGE_HEIGHT "current_image_height"
 #define CONFIG_CURRENT_NX "current_nx"
 #define CONFIG_CURRENT_NY "current_ny"
+#define CONFIG_MODEL_CACHE_DIR "model_cache_dir"
 
 #define CONFIG_PLANE_DEFAULT_X "plane_default_x"
 #define CONFIG_PLANE_DEFAULT_Y "plane_default_y"
@@ -0,0 +1,350 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_CURL_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_CURL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "aliases.hpp"
+#include "field.hpp"
+#include "parallel.hpp"
+
+/**
+ * Computes the curl (vorticity) of fields on a tetrahedral mesh. A field is
+ * interpolated linearly within each tetrahedron, so its curl is constant in
+ * the tetrahedron, sum_k grad(N_k) x m_k over the shape functions N_k of the
+ * corners. The curl at a vertex is the mean of the curls of the tetrahedra
+ * that use it, which is what vtkGradientFilter computes for point data.
+ *
+ * Every zone shares the mesh, so the curl at vertex v is one fixed sparse
+ * linear map, sum_w G_vw x m_w over v and its neighbours w, where G_vw is
+ * the mean over v's tetrahedra of the gradient of w's shape function. The
+ * G_vw are assembled once in CSR form (a row per vertex) and applied to
+ * `batch_size` fields at a time as a sparse matrix times dense block
+ * product. Each batch is first transposed to [vertex][component][field], so
+ * every matrix entry is loaded once per batch and applied to all of its
+ * fields in a contiguous, fixed length loop that the compiler vectorises.
+ *
+ * Rows are summed in a fixed order, so results do not depend on the number
+ * of threads.
+ */
+class CurlOperator {
+
+ public:
+
+  /**
+   * The number of fields that are processed together.
+   */
+  static constexpr size_t batch_size = 8;
+
+  /**
+   * Storage reused between batches, so that sweeps over many fields do not
+   * allocate. One per thread.
+   */
+  struct Scratch {
+
+    // Interleaved vectors of fields that are not views.
+    fv_list vectors;
+
+    // The fields of a batch, [vertex][component][field].
+    std::vector<field_scalar> batch;
+
+  };
+
+  /**
+   * Create an empty operator.
+   */
+  CurlOperator() = default;
+
+  /**
+   * Assemble the operator for a mesh.
+   * @param vcl the (v)ertex (c)oordinate (l)ist.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  template<typename Index>
+  CurlOperator(const v_list &vcl, const basic_tet_list<Index> &til, size_t n_threads = 0) :
+      _n_verts{vcl.size()} {
+
+    // The tetrahedra of each vertex, in ascending order.
+    std::vector<size_t> vertex_offsets(_n_verts + 1, 0);
+    for (const auto &tet : til) {
+      for (auto v : tet) ++vertex_offsets[v + 1];
+    }
+    for (size_t v = 0; v < _n_verts; ++v) vertex_offsets[v + 1] += vertex_offsets[v];
+
+    std::vector<size_t> vertex_tets(vertex_offsets[_n_verts]);
+    {
+      std::vector<size_t> fill(vertex_offsets.begin(), vertex_offsets.end() - 1);
+      for (size_t t = 0; t < til.size(); ++t) {
+        for (auto v : til[t]) vertex_tets[fill[v]++] = t;
+      }
+    }
+
+    std::vector<std::array<std::array<double, 3>, 4>> gradients(til.size());
+    parallel_for_blocks(til.size(), 1 << 14, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; ++t) gradients[t] = shape_gradients(vcl, til[t]);
+    }, n_threads);
+
+    // The (column, tetrahedron corner) pairs that make up a row are sorted by
+    // column and then by corner, so equal columns are summed in a fixed
+    // order. Rows are assembled in chunks, each in to its own storage, and
+    // then concatenated.
+    struct Entry {
+      size_t column;
+      size_t corner;
+    };
+
+    struct Chunk {
+      std::vector<size_t> row_sizes;
+      std::vector<size_t> columns;
+      std::vector<double> gradients;
+    };
+
+    constexpr size_t chunk_rows = 1 << 12;
+    std::vector<Chunk> chunks((_n_verts + chunk_rows - 1) / chunk_rows);
+
+    parallel_for(chunks.size(), [&](size_t c) {
+
+      Chunk &chunk = chunks[c];
+      std::vector<Entry> entries;
+
+      for (size_t v = c * chunk_rows, end = std::min(v + chunk_rows, _n_verts); v < end; ++v) {
+
+        entries.clear();
+        for (size_t i = vertex_offsets[v]; i < vertex_offsets[v + 1]; ++i) {
+          size_t t = vertex_tets[i];
+          for (size_t k = 0; k < 4; ++k) entries.push_back({(size_t) til[t][k], 4 * t + k});
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+          return a.column < b.column || (a.column == b.column && a.corner < b.corner);
+        });
+
+        double scale = 1.0 / (double) std::max<size_t>(vertex_offsets[v + 1] - vertex_offsets[v], 1);
+        size_t row_size = 0;
+
+        for (size_t i = 0; i < entries.size(); ++row_size) {
+          std::array<double, 3> sum{};
+          size_t column = entries[i].column;
+          for (; i < entries.size() && entries[i].column == column; ++i) {
+            const auto &gradient = gradients[entries[i].corner / 4][entries[i].corner % 4];
+            for (size_t k = 0; k < 3; ++k) sum[k] += gradient[k];
+          }
+          chunk.columns.push_back(column);
+          for (size_t k = 0; k < 3; ++k) chunk.gradients.push_back(sum[k] * scale);
+        }
+
+        chunk.row_sizes.push_back(row_size);
+
+      }
+
+    }, n_threads);
+
+    _offsets.assign(_n_verts + 1, 0);
+    std::vector<size_t> chunk_offsets(chunks.size() + 1, 0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+      size_t v = c * chunk_rows;
+      for (size_t row_size : chunks[c].row_sizes) {
+        _offsets[v + 1] = _offsets[v] + row_size;
+        ++v;
+      }
+      chunk_offsets[c + 1] = _offsets[v];
+    }
+
+    _columns.resize(_offsets[_n_verts]);
+    _gradients.resize(3 * _offsets[_n_verts]);
+
+    parallel_for(chunks.size(), [&](size_t c) {
+      std::copy(chunks[c].columns.begin(), chunks[c].columns.end(), _columns.begin() + (ptrdiff_t) chunk_offsets[c]);
+      std::copy(chunks[c].gradients.begin(), chunks[c].gradients.end(),
+                _gradients.begin() + (ptrdiff_t) (3 * chunk_offsets[c]));
+      chunks[c] = {};
+    }, n_threads);
+
+  }
+
+  /**
+   * Retrieve the number of vertices that the operator applies to.
+   * @return the number of vertices.
+   */
+  [[nodiscard]] size_t
+  n_verts() const { return _n_verts; }
+
+  /**
+   * Retrieve the number of stored matrix entries.
+   * @return the number of entries.
+   */
+  [[nodiscard]] size_t
+  n_entries() const { return _columns.size(); }
+
+  /**
+   * Compute the curl of a field at every vertex.
+   * @param field the field.
+   * @param curl the curl at each vertex, resized to the number of vertices.
+   * @param scratch storage reused between calls.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  void
+  apply(const Field &field, fv_list &curl, Scratch &scratch, size_t n_threads = 0) const {
+    const Field *fields[] = {&field};
+    apply(fields, std::span<fv_list>{&curl, 1}, scratch, n_threads);
+  }
+
+  /**
+   * Compute the curl of many fields at every vertex, `batch_size` fields at
+   * a time.
+   * @param fields the fields.
+   * @param curls the curl of each field at each vertex, each is resized to
+   *              the number of vertices. This must be as long as `fields`.
+   * @param scratch storage reused between calls.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  void
+  apply(std::span<const Field *const> fields, std::span<fv_list> curls, Scratch &scratch,
+        size_t n_threads = 0) const {
+
+    if (fields.size() != curls.size()) {
+      throw std::invalid_argument("The number of curls does not match the number of fields.");
+    }
+
+    for (const Field *field : fields) {
+      if (field->size() != _n_verts) {
+        throw std::invalid_argument("Field size does not match the number of vertices.");
+      }
+    }
+
+    constexpr size_t row = 3 * batch_size;
+    scratch.batch.resize(row * _n_verts);
+    field_scalar *batch = scratch.batch.data();
+
+    for (size_t first = 0; first < fields.size(); first += batch_size) {
+
+      size_t n = std::min(batch_size, fields.size() - first);
+
+      // Transpose the batch, unused slots are zero.
+      for (size_t b = 0; b < batch_size; ++b) {
+
+        const Field *field = b < n ? fields[first + b] : nullptr;
+
+        if (field && field->is_view()) {
+          auto x = field->component(0), y = field->component(1), z = field->component(2);
+          parallel_for_blocks(_n_verts, 1 << 14, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+              batch[i * row + b] = x[i];
+              batch[i * row + batch_size + b] = y[i];
+              batch[i * row + 2 * batch_size + b] = z[i];
+            }
+          }, n_threads);
+        } else if (field) {
+          const fv_list &vectors = field->interleaved(scratch.vectors);
+          parallel_for_blocks(_n_verts, 1 << 14, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+              for (size_t c = 0; c < 3; ++c) batch[i * row + c * batch_size + b] = vectors[i][c];
+            }
+          }, n_threads);
+        } else {
+          parallel_for_blocks(_n_verts, 1 << 14, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+              for (size_t c = 0; c < 3; ++c) batch[i * row + c * batch_size + b] = 0;
+            }
+          }, n_threads);
+        }
+
+      }
+
+      for (size_t b = 0; b < n; ++b) curls[first + b].resize(_n_verts);
+
+      parallel_for_blocks(_n_verts, 1 << 12, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+
+          double cx[batch_size]{}, cy[batch_size]{}, cz[batch_size]{};
+
+          for (size_t j = _offsets[v]; j < _offsets[v + 1]; ++j) {
+            const double gx = _gradients[3 * j], gy = _gradients[3 * j + 1], gz = _gradients[3 * j + 2];
+            const field_scalar *mx = batch + _columns[j] * row;
+            const field_scalar *my = mx + batch_size;
+            const field_scalar *mz = my + batch_size;
+            for (size_t b = 0; b < batch_size; ++b) {
+              cx[b] += gy * mz[b] - gz * my[b];
+              cy[b] += gz * mx[b] - gx * mz[b];
+              cz[b] += gx * my[b] - gy * mx[b];
+            }
+          }
+
+          for (size_t b = 0; b < n; ++b) {
+            curls[first + b][v] = {(field_scalar) cx[b], (field_scalar) cy[b], (field_scalar) cz[b]};
+          }
+
+        }
+      }, n_threads);
+
+    }
+
+  }
+
+  /**
+   * Retrieve the size of the operator.
+   * @return the number of bytes held.
+   */
+  [[nodiscard]] size_t
+  size_bytes() const {
+    return (_offsets.size() + _columns.size()) * sizeof(size_t) + _gradients.size() * sizeof(double);
+  }
+
+ private:
+
+  size_t _n_verts{0};
+
+  // The operator in CSR form, row v holds G_vw for v and its neighbours w in
+  // ascending order of w, three gradient components per entry.
+  std::vector<size_t> _offsets;
+  std::vector<size_t> _columns;
+  std::vector<double> _gradients;
+
+  /**
+   * Compute the gradients of the shape functions of a tetrahedron's
+   * corners, degenerate tetrahedra get zero gradients.
+   */
+  template<typename Tet>
+  static std::array<std::array<double, 3>, 4>
+  shape_gradients(const v_list &vcl, const Tet &tet) {
+
+    const auto &p0 = vcl[tet[0]];
+    std::array<std::array<double, 3>, 3> e{};
+    for (size_t k = 0; k < 3; ++k) {
+      for (size_t c = 0; c < 3; ++c) e[k][c] = vcl[tet[k + 1]][c] - p0[c];
+    }
+
+    // The gradients of the barycentric coordinates of corners 1 to 3 are the
+    // rows of the inverse of the edge matrix, corner 0's is minus their sum.
+    std::array<std::array<double, 3>, 3> rows{cross(e[1], e[2]), cross(e[2], e[0]), cross(e[0], e[1])};
+    double det = e[0][0] * rows[0][0] + e[0][1] * rows[0][1] + e[0][2] * rows[0][2];
+    double scale = det != 0.0 ? 1.0 / det : 0.0;
+
+    std::array<std::array<double, 3>, 4> gradients{};
+    for (size_t c = 0; c < 3; ++c) {
+      gradients[1][c] = rows[0][c] * scale;
+      gradients[2][c] = rows[1][c] * scale;
+      gradients[3][c] = rows[2][c] * scale;
+      gradients[0][c] = -(gradients[1][c] + gradients[2][c] + gradients[3][c]);
+    }
+
+    return gradients;
+
+  }
+
+  static std::array<double, 3>
+  cross(const std::array<double, 3> &a, const std::array<double, 3> &b) {
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_CURL_HPP_
@@ -5,14 +5,223 @@
 #ifndef MMPPT_TOY_QT_VTK_EX005_FIELD_HPP_
 #define MMPPT_TOY_QT_VTK_EX005_FIELD_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
-#include <utility>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 
 #include "aliases.hpp"
+#include "octahedral.hpp"
+
+/**
+ * Holds the vectors of many fields in a single contiguous allocation, laid
+ * out as [zone][component][vertex]. Every component row starts on a 64 byte
+ * boundary (rows are zero padded), so per-component kernels and reductions
+ * over many zones stream linearly through memory.
+ * @tparam T the scalar type of the vector components (float or double).
+ */
+template<typename T>
+class BasicFieldBlock {
+
+ public:
+
+  /**
+   * The alignment of the block and of every component row, in bytes.
+   */
+  static constexpr size_t alignment = 64;
+
+  /**
+   * Create an empty block.
+   */
+  BasicFieldBlock() = default;
+
+  /**
+   * Create a block, the values are uninitialised.
+   * @param n_verts the number of vectors in each zone.
+   * @param n_zones the number of zones.
+   */
+  explicit BasicFieldBlock(size_t n_verts, size_t n_zones = 0) :
+      _n_verts{n_verts},
+      _stride{(n_verts + row_values - 1) / row_values * row_values} {
+    resize(n_zones);
+  }
+
+  BasicFieldBlock(BasicFieldBlock &&other) noexcept = default;
+
+  BasicFieldBlock &
+  operator=(BasicFieldBlock &&other) noexcept = default;
+
+  /**
+   * Retrieve the number of vectors in each zone.
+   * @return the number of vectors in each zone.
+   */
+  [[nodiscard]] size_t
+  n_verts() const { return _n_verts; }
+
+  /**
+   * Retrieve the number of zones.
+   * @return the number of zones.
+   */
+  [[nodiscard]] size_t
+  n_zones() const { return _n_zones; }
+
+  /**
+   * Retrieve the distance, in values, between consecutive component rows.
+   * @return the row stride, this is n_verts() rounded up to the alignment.
+   */
+  [[nodiscard]] size_t
+  stride() const { return _stride; }
+
+  /**
+   * Retrieve a component row of a zone.
+   * @param zone the index of the zone.
+   * @param component the component (0, 1 or 2 for x, y or z).
+   * @return the n_verts() values of the component.
+   */
+  [[nodiscard]] std::span<const T>
+  component(size_t zone, size_t component) const {
+    return {_data.get() + (3 * zone + component) * _stride, _n_verts};
+  }
+
+  /**
+   * Retrieve a component row of a zone.
+   * @param zone the index of the zone.
+   * @param component the component (0, 1 or 2 for x, y or z).
+   * @return the n_verts() values of the component.
+   */
+  [[nodiscard]] std::span<T>
+  component(size_t zone, size_t component) {
+    return {_data.get() + (3 * zone + component) * _stride, _n_verts};
+  }
+
+  /**
+   * Retrieve the whole block, including row padding.
+   * @return the 3 * stride() * n_zones() values of the block.
+   */
+  [[nodiscard]] std::span<const T>
+  data() const { return {_data.get(), 3 * _stride * _n_zones}; }
+
+  /**
+   * Make room for at least `n_zones` zones without changing the number of
+   * zones.
+   * @param n_zones the number of zones.
+   */
+  void
+  reserve(size_t n_zones) {
+
+    if (n_zones <= _capacity) return;
+
+    size_t bytes = 3 * _stride * n_zones * sizeof(T);
+    AlignedPtr data{allocate(bytes), Release{bytes}};
+
+    if (_n_zones > 0) {
+      std::memcpy(data.get(), _data.get(), 3 * _stride * _n_zones * sizeof(T));
+    }
+
+    _data = std::move(data);
+    _capacity = n_zones;
+
+  }
+
+  /**
+   * Change the number of zones, existing zones are kept and new zones are
+   * uninitialised (apart from their row padding). The capacity grows
+   * geometrically so that zones can be added one at a time.
+   * @param n_zones the number of zones.
+   */
+  void
+  resize(size_t n_zones) {
+
+    if (n_zones > _capacity) {
+      reserve(std::max(n_zones, 2 * _capacity));
+    }
+
+    for (size_t row = 3 * _n_zones; row < 3 * n_zones; ++row) {
+      std::fill(_data.get() + row * _stride + _n_verts, _data.get() + (row + 1) * _stride, T{0});
+    }
+
+    _n_zones = n_zones;
+
+  }
+
+ private:
+
+  // The number of values in one alignment unit.
+  static constexpr size_t row_values = alignment / sizeof(T);
+
+  // Blocks at least this large are mapped directly rather than taken from
+  // the heap. Otherwise the allocator's adaptive mmap threshold puts repeat
+  // loads of tens of megabytes on the heap, which then fragments and is not
+  // given back to the OS.
+  static constexpr size_t mapped_bytes = 1 << 20;
+
+  struct Release {
+    Release() noexcept : bytes{0} {}
+    explicit Release(size_t bytes) noexcept : bytes{bytes} {}
+    size_t bytes;
+    void operator()(T *data) const {
+#ifndef _WIN32
+      if (bytes >= mapped_bytes) {
+        ::munmap(data, bytes);
+        return;
+      }
+#endif
+      ::operator delete(data, std::align_val_t{alignment});
+    }
+  };
+
+  using AlignedPtr = std::unique_ptr<T[], Release>;
+
+  /**
+   * Allocate storage that is aligned to `alignment` bytes.
+   * @param bytes the size of the storage.
+   * @return the storage, which must be released with Release{bytes}.
+   */
+  static T *
+  allocate(size_t bytes) {
+#ifndef _WIN32
+    if (bytes >= mapped_bytes) {
+      void *addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (addr == MAP_FAILED) throw std::bad_alloc();
+      return static_cast<T *>(addr);
+    }
+#endif
+    return static_cast<T *>(::operator new(bytes, std::align_val_t{alignment}));
+  }
+
+  AlignedPtr _data;
+
+  size_t _n_verts{0};
+
+  size_t _stride{0};
+
+  size_t _n_zones{0};
+
+  size_t _capacity{0};
+
+};
+
+// Field block with the configured field precision.
+using FieldBlock = BasicFieldBlock<field_scalar>;
 
 /**
  * Holds a field - which is a collection of vectors associated with vertices.
+ * A field either owns its vectors, is a view of one zone of a shared
+ * FieldBlock, or holds its vectors octahedrally quantised (decoded on
+ * access).
  */
 class Field {
 
@@ -51,18 +260,189 @@ class Field {
       _vectors{std::move(vectors)} {}
 
   /**
-   * Retrieve a const list of vectors.
+   * Create a new Field object that is a view of one zone of a block.
+   * @param annotation annotation for the vector field.
+   * @param block the block, this is kept alive by the field.
+   * @param zone the index of the zone within the block.
+   */
+  Field(std::string annotation, std::shared_ptr<const FieldBlock> block, size_t zone) :
+      _annotation{std::move(annotation)},
+      _block{std::move(block)},
+      _zone{zone} {}
+
+  /**
+   * Create a new Field object from quantised vectors.
+   * @param annotation annotation for the vector field.
+   * @param quantised the quantised vectors.
+   */
+  Field(std::string annotation, std::shared_ptr<const OctahedralVectors> quantised) :
+      _annotation{std::move(annotation)},
+      _quantised{std::move(quantised)} {}
+
+  /**
+   * Create a quantised copy of this field, this takes 4 bytes per unit
+   * vector (8 if some vectors are not unit length) and loses at most
+   * OctahedralVectors::max_angular_error of direction.
+   * @return the quantised field.
+   */
+  [[nodiscard]] Field
+  quantised() const {
+    if (_quantised) return *this;
+    return {_annotation,
+            std::make_shared<const OctahedralVectors>(size(), [this](size_t i) { return vector(i); })};
+  }
+
+  /**
+   * Create a copy of this field with its vectors in a different order.
+   * Quantised fields stay quantised, other fields own the reordered
+   * vectors.
+   * @param order the old index of each new index.
+   * @return the reordered field.
+   */
+  [[nodiscard]] Field
+  permuted(const vi_list &order) const {
+
+    if (order.size() != size()) {
+      throw std::invalid_argument("The order does not match the number of vectors in the field.");
+    }
+
+    if (_quantised) {
+      return {_annotation, std::make_shared<const OctahedralVectors>(_quantised->permuted(order))};
+    }
+
+    fv_list vectors(order.size());
+    for (size_t i = 0; i < order.size(); ++i) vectors[i] = vector(order[i]);
+
+    return {_annotation, std::move(vectors)};
+
+  }
+
+  /**
+   * Check whether this field is a view of a FieldBlock.
+   * @return true if this field is a view, false if it owns its vectors.
+   */
+  [[nodiscard]] bool
+  is_view() const { return _block != nullptr; }
+
+  /**
+   * Check whether this field holds quantised vectors.
+   * @return true if the vectors are quantised, otherwise false.
+   */
+  [[nodiscard]] bool
+  is_quantised() const { return _quantised != nullptr; }
+
+  /**
+   * Retrieve the quantised vectors, this is only available for quantised
+   * fields.
+   * @return the quantised vectors.
+   */
+  [[nodiscard]] const OctahedralVectors &
+  quantised_vectors() const {
+    if (!_quantised) throw std::logic_error("quantised_vectors() is only available for a quantised field.");
+    return *_quantised;
+  }
+
+  /**
+   * Retrieve the number of vectors.
+   * @return the number of vectors.
+   */
+  [[nodiscard]] size_t
+  size() const {
+    if (_block) return _block->n_verts();
+    if (_quantised) return _quantised->size();
+    return _vectors.size();
+  }
+
+  /**
+   * Retrieve a single vector.
+   * @param index the index of the vector.
+   * @return the vector.
+   */
+  [[nodiscard]] fv
+  vector(size_t index) const {
+
+    if (_quantised) {
+      fv vector;
+      _quantised->decode(index, 1, vector.data());
+      return vector;
+    }
+
+    if (!_block) return _vectors[index];
+
+    return {
+        _block->component(_zone, 0)[index],
+        _block->component(_zone, 1)[index],
+        _block->component(_zone, 2)[index]
+    };
+
+  }
+
+  /**
+   * Retrieve one component of every vector, this is only available for
+   * views.
+   * @param component the component (0, 1 or 2 for x, y or z).
+   * @return the values of the component.
+   */
+  [[nodiscard]] std::span<const field_scalar>
+  component(size_t component) const {
+    if (!_block) throw std::logic_error("component() is only available for a field view.");
+    return _block->component(_zone, component);
+  }
+
+  /**
+   * Retrieve a const list of vectors, this is not available for views or
+   * quantised fields.
    * @return the vectors comprising the field.
    */
   [[nodiscard]] const fv_list &
-  vectors() const { return _vectors; }
+  vectors() const {
+    if (_block || _quantised) {
+      throw std::logic_error("vectors() is only available for a field that owns its vectors, use interleaved().");
+    }
+    return _vectors;
+  }
 
   /**
-   * Retrieve a list of vectors.
+   * Retrieve a list of vectors, this is not available for views or quantised
+   * fields.
    * @return the vectors comprising the field.
    */
   fv_list &
-  vectors() { return _vectors; }
+  vectors() {
+    if (_block || _quantised) {
+      throw std::logic_error("vectors() is only available for a field that owns its vectors, use interleaved().");
+    }
+    return _vectors;
+  }
+
+  /**
+   * Retrieve the vectors interleaved ([vertex][component]), fields that own
+   * their vectors return them directly, views and quantised fields are
+   * interleaved (decoded) in to `scratch`.
+   * @param scratch storage for the interleaved vectors of a view or quantised
+   *                field.
+   * @return the vectors comprising the field.
+   */
+  [[nodiscard]] const fv_list &
+  interleaved(fv_list &scratch) const {
+
+    if (_quantised) {
+      scratch.resize(size());
+      if (!scratch.empty()) _quantised->decode(0, scratch.size(), scratch.front().data());
+      return scratch;
+    }
+
+    if (!_block) return _vectors;
+
+    scratch.resize(size());
+    for (size_t c = 0; c < 3; ++c) {
+      auto values = _block->component(_zone, c);
+      for (size_t i = 0; i < values.size(); ++i) scratch[i][c] = values[i];
+    }
+
+    return scratch;
+
+  }
 
   /**
    * Retrieve the annotation of the field.
@@ -79,36 +459,218 @@ class Field {
   // The field's vectors.
   fv_list _vectors;
 
+  // The block that this field is a view of, null if the field owns its
+  // vectors.
+  std::shared_ptr<const FieldBlock> _block;
+
+  // The zone of the block that this field is a view of.
+  size_t _zone{0};
+
+  // The quantised vectors, null unless the field is quantised.
+  std::shared_ptr<const OctahedralVectors> _quantised;
+
+};
+
+/**
+ * A source from which the fields of a lazy field list are decoded on demand,
+ * for example the zones of a memory mapped tecplot file.
+ */
+class FieldSource {
+
+ public:
+
+  virtual ~FieldSource() = default;
+
+  /**
+   * Retrieve the number of fields that this source provides.
+   * @return the number of fields.
+   */
+  [[nodiscard]] virtual size_t
+  n_fields() const = 0;
+
+  /**
+   * Decode a field, this must be safe to call from several threads at once.
+   * @param index the index of the field.
+   * @return the decoded field.
+   */
+  [[nodiscard]] virtual Field
+  load(size_t index) const = 0;
+
 };
 
 /**
- * Holds a collection of fields.
+ * A source that reorders the fields of another source, for the fields of a
+ * mesh whose vertices have been renumbered.
+ */
+class PermutedFieldSource : public FieldSource {
+
+ public:
+
+  /**
+   * Create a new source.
+   * @param source the source that fields are decoded from.
+   * @param order the old index of each new vertex index.
+   */
+  PermutedFieldSource(std::shared_ptr<const FieldSource> source, std::shared_ptr<const vi_list> order) :
+      _source{std::move(source)},
+      _order{std::move(order)} {}
+
+  [[nodiscard]] size_t
+  n_fields() const override { return _source->n_fields(); }
+
+  [[nodiscard]] Field
+  load(size_t index) const override { return _source->load(index).permuted(*_order); }
+
+ private:
+
+  std::shared_ptr<const FieldSource> _source;
+
+  std::shared_ptr<const vi_list> _order;
+
+};
+
+/**
+ * Holds a collection of fields. Fields are either held in memory (eager) or
+ * decoded from a `FieldSource` the first time they are asked for (lazy), in
+ * which case at most `max_resident` decoded fields are kept in a least
+ * recently used cache.
  */
 class FieldList {
 
  public:
 
+  /**
+   * A shared handle to a field, the field stays alive for as long as the
+   * handle does even if it is evicted from the cache in the meantime.
+   */
+  using FieldPtr = std::shared_ptr<const Field>;
+
+  /**
+   * The default number of lazily loaded fields that are kept in memory.
+   */
+  static constexpr size_t default_max_resident = 16;
+
+  /**
+   * The ways in which resident lazily loaded fields are held.
+   */
+  enum class Encoding {
+    // As decoded from the source.
+    Full,
+    // Octahedrally quantised (see OctahedralVectors), so that several times
+    // more fields fit in the same memory.
+    Octahedral
+  };
+
   /**
    * A default constructor.
    */
   FieldList() = default;
 
   /**
-   * Retrieve the fields associated with this field list.
+   * Create a lazy field list.
+   * @param source the source that fields are decoded from.
+   * @param max_resident the maximum number of decoded fields kept in memory.
+   */
+  explicit FieldList(std::shared_ptr<const FieldSource> source,
+                     size_t max_resident = default_max_resident) :
+      _cache{std::make_shared<Cache>(std::move(source), max_resident)} {}
+
+  /**
+   * Create a field list whose fields are views of the zones of a single
+   * contiguous block.
+   * @param block the block.
+   * @param annotations the annotation of each zone.
+   */
+  FieldList(std::shared_ptr<const FieldBlock> block, const std::vector<std::string> &annotations) :
+      _block{std::move(block)} {
+
+    if (annotations.size() != _block->n_zones()) {
+      throw std::invalid_argument("The number of annotations does not match the number of zones.");
+    }
+
+    _fields.reserve(_block->n_zones());
+    for (size_t zone = 0; zone < _block->n_zones(); ++zone) {
+      _fields.emplace_back(annotations[zone], _block, zone);
+    }
+
+  }
+
+  /**
+   * Retrieve the fields associated with this field list, this is only
+   * available for eager field lists.
    * @return the fields in this field list.
    */
   [[nodiscard]] const std::vector<Field> &
-  fields() const { return _fields; }
+  fields() const {
+    if (is_lazy()) throw std::logic_error("fields() is not available for a lazy field list, use field().");
+    return _fields;
+  }
 
   /**
-   * Retrieve the fields associated with this field list.
+   * Retrieve the fields associated with this field list, this is only
+   * available for eager field lists.
    * @return the fields in this field list.
    */
   std::vector<Field> &
-  fields() { return _fields; }
+  fields() {
+    if (is_lazy()) throw std::logic_error("fields() is not available for a lazy field list, use field().");
+    return _fields;
+  }
+
+  /**
+   * Retrieve a single field, for a lazy field list the field is decoded if
+   * it is not resident. Handles to eagerly held fields are invalidated by
+   * `add_field()`.
+   * @param index the index of the field.
+   * @return a handle to the field.
+   */
+  [[nodiscard]] FieldPtr
+  field(size_t index) const {
+
+    size_t n_lazy = _cache ? _cache->source->n_fields() : 0;
+
+    if (index < n_lazy) return _cache->get(index);
+
+    // Aliasing constructor, eagerly held fields are owned by this list.
+    return {FieldPtr{}, &_fields.at(index - n_lazy)};
+
+  }
+
+  /**
+   * Put an already decoded field in to the cache of a lazy field list, so
+   * that it does not have to be decoded again when it is first asked for.
+   * @param index the index of the field.
+   * @param field the field.
+   */
+  void
+  preload(size_t index, Field field) {
+    if (!is_lazy()) throw std::logic_error("preload() is only available for a lazy field list.");
+    _cache->put(index, _cache->hold(std::move(field)));
+  }
+
+  /**
+   * Set how resident fields of a lazy field list are held. Fields that are
+   * already resident are quantised, or when switching back to Full evicted
+   * so that they are decoded again at full precision. Handles to fields that
+   * were handed out before are not affected.
+   * @param encoding the encoding.
+   */
+  void
+  set_encoding(Encoding encoding) {
+    if (!is_lazy()) throw std::logic_error("set_encoding() is only available for a lazy field list.");
+    _cache->set_encoding(encoding);
+  }
+
+  /**
+   * Retrieve how resident fields of a lazy field list are held.
+   * @return the encoding, Full for eager field lists.
+   */
+  [[nodiscard]] Encoding
+  encoding() const { return _cache ? _cache->encoding.load() : Encoding::Full; }
 
   /**
-   * Add a field to this field list.
+   * Add a field to this field list, for a lazy field list the field is held
+   * in memory and comes after the fields of the source.
    * @param field the field t add.
    */
   void
@@ -119,12 +681,199 @@ class FieldList {
    * @return the number of fields in this list.
    */
   [[nodiscard]] size_t
-  n_fields() const { return _fields.size(); }
+  n_fields() const {
+    return (_cache ? _cache->source->n_fields() : 0) + _fields.size();
+  }
+
+  /**
+   * Check whether fields are decoded on demand.
+   * @return true if this is a lazy field list, otherwise false.
+   */
+  [[nodiscard]] bool
+  is_lazy() const { return _cache != nullptr; }
+
+  /**
+   * Retrieve the block that the first `block()->n_zones()` fields are views
+   * of, for kernels that work on many zones at once.
+   * @return the block, null if the fields are not held in a single block.
+   */
+  [[nodiscard]] const std::shared_ptr<const FieldBlock> &
+  block() const { return _block; }
+
+  /**
+   * Retrieve the number of lazily loaded fields that are currently resident.
+   * @return the number of resident fields, zero for eager field lists.
+   */
+  [[nodiscard]] size_t
+  n_resident() const { return _cache ? _cache->size() : 0; }
+
+  /**
+   * Create a copy of this field list with the vectors of every field
+   * reordered, for the fields of a mesh whose vertices have been
+   * renumbered. A block is copied in to a new block, a lazy list decodes
+   * through a PermutedFieldSource and keeps its resident fields (reordered).
+   * @param order the old index of each new vertex index.
+   * @return the reordered field list.
+   */
+  [[nodiscard]] FieldList
+  permuted(const std::shared_ptr<const vi_list> &order) const {
+
+    FieldList result;
+
+    size_t n_block = 0;
+    if (_block) {
+
+      auto block = std::make_shared<FieldBlock>(order->size(), _block->n_zones());
+      std::vector<std::string> annotations;
+      annotations.reserve(_block->n_zones());
+
+      for (size_t zone = 0; zone < _block->n_zones(); ++zone) {
+        for (size_t c = 0; c < 3; ++c) {
+          auto from = _block->component(zone, c);
+          auto to = block->component(zone, c);
+          for (size_t i = 0; i < to.size(); ++i) to[i] = from[(*order)[i]];
+        }
+        annotations.push_back(_fields[zone].annotation());
+      }
+
+      result = FieldList{std::shared_ptr<const FieldBlock>{std::move(block)}, annotations};
+      n_block = _block->n_zones();
+
+    }
+
+    for (size_t i = n_block; i < _fields.size(); ++i) result._fields.push_back(_fields[i].permuted(*order));
+
+    if (_cache) {
+
+      result._cache = std::make_shared<Cache>(std::make_shared<const PermutedFieldSource>(_cache->source, order),
+                                              _cache->max_resident);
+      result._cache->encoding = _cache->encoding.load();
+
+      // Least recently used first, so that the new cache has the same order.
+      std::lock_guard<std::mutex> lock{_cache->mutex};
+      for (auto it = _cache->lru.rbegin(); it != _cache->lru.rend(); ++it) {
+        const Field &field = *_cache->entries.at(*it).first;
+        result._cache->put(*it, std::make_shared<const Field>(field.permuted(*order)));
+      }
+
+    }
+
+    return result;
+
+  }
 
  private:
 
+  /**
+   * Least recently used cache of decoded fields.
+   */
+  struct Cache {
+
+    Cache(std::shared_ptr<const FieldSource> source, size_t max_resident) :
+        source{std::move(source)},
+        max_resident{std::max<size_t>(max_resident, 1)} {}
+
+    FieldPtr
+    get(size_t index) {
+
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        auto it = entries.find(index);
+        if (it != entries.end()) {
+          lru.splice(lru.begin(), lru, it->second.second);
+          return it->second.first;
+        }
+      }
+
+      // Decode outside the lock so that different fields can be decoded
+      // concurrently.
+      return put(index, hold(source->load(index)));
+
+    }
+
+    FieldPtr
+    hold(Field field) const {
+      if (encoding == Encoding::Octahedral) field = field.quantised();
+      return std::make_shared<const Field>(std::move(field));
+    }
+
+    void
+    set_encoding(Encoding new_encoding) {
+
+      std::lock_guard<std::mutex> lock{mutex};
+
+      encoding = new_encoding;
+
+      for (auto it = entries.begin(); it != entries.end();) {
+        if (new_encoding == Encoding::Octahedral) {
+          it->second.first = hold(*it->second.first);
+          ++it;
+        } else if (it->second.first->is_quantised()) {
+          // Evict, so that the field is decoded again at full precision.
+          lru.erase(it->second.second);
+          it = entries.erase(it);
+        } else {
+          ++it;
+        }
+      }
+
+    }
+
+    FieldPtr
+    put(size_t index, FieldPtr field) {
+
+      std::lock_guard<std::mutex> lock{mutex};
+
+      auto it = entries.find(index);
+      if (it != entries.end()) {
+        // Another thread got there first.
+        lru.splice(lru.begin(), lru, it->second.second);
+        return it->second.first;
+      }
+
+      lru.push_front(index);
+      entries.emplace(index, std::make_pair(field, lru.begin()));
+
+      while (entries.size() > max_resident) {
+        entries.erase(lru.back());
+        lru.pop_back();
+      }
+
+      return field;
+
+    }
+
+    size_t
+    size() {
+      std::lock_guard<std::mutex> lock{mutex};
+      return entries.size();
+    }
+
+    std::shared_ptr<const FieldSource> source;
+
+    size_t max_resident;
+
+    std::atomic<Encoding> encoding{Encoding::Full};
+
+    std::mutex mutex;
+
+    // Field indices, most recently used first.
+    std::list<size_t> lru;
+
+    std::unordered_map<size_t, std::pair<FieldPtr, std::list<size_t>::iterator>> entries;
+
+  };
+
+  // Eagerly held fields.
   std::vector<Field> _fields;
 
+  // Cache of lazily loaded fields, null for eager field lists.
+  std::shared_ptr<Cache> _cache;
+
+  // Contiguous storage of the fields, null unless the field list was
+  // created from a block.
+  std::shared_ptr<const FieldBlock> _block;
+
 };
 
 #endif // MMPPT_TOY_QT_VTK_EX005_FIELD_HPP_
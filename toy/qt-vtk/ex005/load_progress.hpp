@@ -0,0 +1,135 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_LOAD_PROGRESS_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_LOAD_PROGRESS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <utility>
+
+/**
+ * Object that will be thrown when loading is cancelled.
+ */
+class LoadCancelledException : public std::exception {
+
+ public:
+
+  [[nodiscard]] const char *
+  what() const noexcept override {
+    return "Loading was cancelled.";
+  }
+
+};
+
+/**
+ * Reports the progress of a (possibly multithreaded) load and lets it be
+ * cancelled. Work is divided in to stages, each with its own total, e.g. the
+ * number of bytes to parse or the number of zones to process. The callback
+ * is only invoked when the completed percentage of a stage changes, it may
+ * be invoked from any thread that is doing the work.
+ */
+class LoadProgress {
+
+ public:
+
+  /**
+   * Function that receives the stage name, the amount of work done and the
+   * total amount of work in the stage (zero if the total is unknown).
+   */
+  using Callback = std::function<void(const std::string &stage, size_t done, size_t total)>;
+
+  /**
+   * Create a new progress object.
+   * @param callback function that is told about progress.
+   * @param stop_token token that is used to request cancellation.
+   */
+  explicit LoadProgress(Callback callback, std::stop_token stop_token = {}) :
+      _callback{std::move(callback)},
+      _stop_token{std::move(stop_token)} {}
+
+  /**
+   * Start a new stage of work, this must not be called while work of the
+   * previous stage is still in progress.
+   * @param stage the name of the stage.
+   * @param total the total amount of work in the stage.
+   */
+  void
+  start(std::string stage, size_t total) {
+
+    check_cancelled();
+
+    _stage = std::move(stage);
+    _total = total;
+    _done = 0;
+    _percent = 0;
+
+    if (_callback) _callback(_stage, 0, _total);
+
+  }
+
+  /**
+   * Record that some work has been done, this is safe to call from several
+   * threads at once.
+   * @param amount the amount of work.
+   * @throws LoadCancelledException if cancellation has been requested.
+   */
+  void
+  advance(size_t amount) {
+
+    check_cancelled();
+
+    size_t done = _done.fetch_add(amount) + amount;
+
+    if (!_callback || _total == 0) return;
+
+    size_t percent = 100 * std::min(done, _total) / _total;
+    size_t previous = _percent.load();
+    while (percent > previous) {
+      if (_percent.compare_exchange_weak(previous, percent)) {
+        _callback(_stage, done, _total);
+        break;
+      }
+    }
+
+  }
+
+  /**
+   * Check whether cancellation has been requested.
+   * @return true if the load should stop, otherwise false.
+   */
+  [[nodiscard]] bool
+  cancelled() const { return _stop_token.stop_requested(); }
+
+  /**
+   * Stop the load if cancellation has been requested.
+   * @throws LoadCancelledException if cancellation has been requested.
+   */
+  void
+  check_cancelled() const {
+    if (cancelled()) throw LoadCancelledException();
+  }
+
+ private:
+
+  Callback _callback;
+
+  std::stop_token _stop_token;
+
+  std::string _stage;
+
+  size_t _total{0};
+
+  std::atomic<size_t> _done{0};
+
+  std::atomic<size_t> _percent{0};
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_LOAD_PROGRESS_HPP_
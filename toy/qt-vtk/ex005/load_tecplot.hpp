@@ -8,11 +8,13 @@
 #include <exception>
 #include <array>
 #include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
-#include <regex>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -21,12 +23,16 @@
 #include "fraction.hpp"
 #include "model.hpp"
 #include "field.hpp"
+#include "load_progress.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include "tecplot_scanner.hpp"
 
 /**
  * Object that will be thrown on tecplot file '*.tec" loading
  * exception.
  */
-class TecplotFileLoaderException : std::exception {
+class TecplotFileLoaderException : public std::exception {
 
  public:
 
@@ -52,7 +58,10 @@ class TecplotFileLoaderException : std::exception {
 };
 
 /**
- * Temporary tecplot data class.
+ * Temporary tecplot data class. Values are parsed straight in to the
+ * containers used by Mesh and FieldList, which then adopt them by move, so
+ * loading never holds more than one copy of the model. The fields of all
+ * zones are held in a single FieldBlock.
  */
 class TecplotData {
 
@@ -66,85 +75,45 @@ class TecplotData {
 
   [[nodiscard]] size_t n_zones() const { return _n_zones.value(); }
 
-  [[nodiscard]] std::chrono::minutes processing_time() const { return _processing_time; };
+  [[nodiscard]] std::chrono::milliseconds processing_time() const { return _processing_time; };
 
-  [[nodiscard]] const std::vector<double> &x() const { return _x; }
+  [[nodiscard]] const v_list &verts() const { return _verts; }
 
-  [[nodiscard]] const std::vector<double> &y() const { return _y; }
+  [[nodiscard]] const sm_list &tetra_submesh_idxs() const { return _tetra_submesh_idxs; }
 
-  [[nodiscard]] const std::vector<double> &z() const { return _z; }
+  [[nodiscard]] const Connectivity &tetra_idxs() const { return _tetra_idxs; }
 
-  [[nodiscard]] const std::vector<size_t> &tetra_submesh_idxs() const { return _tetra_submesh_idxs; }
+  [[nodiscard]] const FieldBlock &field_block() const { return _field_block; }
 
-  [[nodiscard]] const std::vector<size_t> &tetra_idxs() const { return _tetra_idxs; }
-
-  [[nodiscard]] const std::vector<std::vector<double>> &mx() const { return _mx; }
-
-  [[nodiscard]] const std::vector<std::vector<double>> &my() const { return _my; }
-
-  [[nodiscard]] const std::vector<std::vector<double>> &mz() const { return _mz; }
-
-  [[nodiscard]] std::vector<std::array<double, 3>>
-  get_verts() const {
-
-    std::vector<std::array<double, 3>> verts(n_verts());
-
-    for (size_t i = 0; i < n_verts(); ++i) {
-      verts[i] = {_x[i], _y[i], _z[i]};
-    }
-
-    return verts;
-
-  }
-
-  [[nodiscard]] std::vector<std::array<size_t, 4>>
-  get_elements() const {
-
-    std::vector<std::array<size_t, 4>> elements(n_elems());
-
-    for (size_t i = 0; i < n_elems(); ++i) {
-      elements[i] = {
-          _tetra_idxs[4*i + 0],
-          _tetra_idxs[4*i + 1],
-          _tetra_idxs[4*i + 2],
-          _tetra_idxs[4*i + 3]
-      };
-    }
-
-    return elements;
-
-  }
-
-  [[nodiscard]] std::vector<size_t>
-  get_submesh_idxs() const {
-
-    std::vector<size_t> submesh_idxs(n_elems());
-
-    for (size_t i = 0; i < n_elems(); ++i) {
-      submesh_idxs[i] = _tetra_submesh_idxs[i];
-    }
+  /**
+   * Move the vertices out of this object.
+   * @return the vertex list.
+   */
+  [[nodiscard]] v_list
+  take_verts() { return std::move(_verts); }
 
-    return submesh_idxs;
+  /**
+   * Move the tetrahedra out of this object.
+   * @return the (0-based) tetrahedra index list.
+   */
+  [[nodiscard]] Connectivity
+  take_elements() { return std::move(_tetra_idxs); }
 
-  }
+  /**
+   * Move the sub-mesh indices out of this object.
+   * @return the sub-mesh index list.
+   */
+  [[nodiscard]] sm_list
+  take_submesh_idxs() { return std::move(_tetra_submesh_idxs); }
 
+  /**
+   * Move every zone out of this object.
+   * @return the fields of all zones, as views of a single block.
+   */
   [[nodiscard]] FieldList
-  get_fields() const {
-
-    FieldList field_list;
-
-    for (size_t zone_idx = 0; zone_idx < n_zones(); ++zone_idx) {
-
-      fv_list field(n_verts());
-      for (size_t i = 0; i < n_verts(); ++i) {
-        field[i] = {_mx[zone_idx][i], _my[zone_idx][i], _mz[zone_idx][i]};
-      }
-
-      field_list.add_field(Field{field});
+  take_fields() {
 
-    }
-
-    return field_list;
+    return {std::make_shared<const FieldBlock>(std::move(_field_block)), _zone_titles};
 
   }
 
@@ -228,51 +197,92 @@ class TecplotData {
     }
   };
 
+  /**
+   * Position of the next value in a block of 3-vectors. Tecplot stores
+   * blocks component by component (every x, then every y, then every z),
+   * which is also the order of a FieldBlock zone, whereas v_list stores
+   * them vertex by vertex.
+   */
+  struct BlockCursor {
+
+    size_t vertex{0};
+    size_t component{0};
+
+    /**
+     * Check whether a block of `n` vectors has been filled.
+     * @param n the number of vectors in the block.
+     * @return true if all 3n values have been read, otherwise false.
+     */
+    [[nodiscard]] bool
+    is_full(size_t n) const { return component >= 3 || n == 0; }
+
+    /**
+     * Store a value and move to the next position.
+     * @param block the block.
+     * @param value the value.
+     */
+    void
+    put(std::vector<std::array<double, 3>> &block, double value) {
+
+      block[vertex][component] = value;
+
+      if (++vertex == block.size()) {
+        vertex = 0;
+        component++;
+      }
+
+    }
+
+    /**
+     * Store a value of a zone of a field block and move to the next
+     * position.
+     * @param block the block.
+     * @param zone the index of the zone.
+     * @param value the value.
+     */
+    void
+    put(FieldBlock &block, size_t zone, double value) {
+
+      block.component(zone, component)[vertex] = (field_scalar) value;
+
+      if (++vertex == block.n_verts()) {
+        vertex = 0;
+        component++;
+      }
+
+    }
+
+  };
+
   std::optional<size_t> _n_verts;
   std::optional<size_t> _n_elems;
   std::optional<size_t> _n_zones;
 
   std::optional<size_t> _current_field_idx;
 
-  std::vector<double> _x;
-  std::vector<double> _y;
-  std::vector<double> _z;
+  v_list _verts;
+  BlockCursor _verts_cursor;
 
-  std::vector<size_t> _tetra_submesh_idxs;
-  std::vector<size_t> _tetra_idxs;
+  sm_list _tetra_submesh_idxs;
+  Connectivity _tetra_idxs;
+  size_t _n_tetra_idx_values{0};
 
-  std::vector<std::vector<double>> _mx;
-  std::vector<std::vector<double>> _my;
-  std::vector<std::vector<double>> _mz;
+  FieldBlock _field_block;
+  std::vector<BlockCursor> _field_cursors;
 
   std::vector<std::string> _zone_titles;
 
-  std::chrono::minutes _processing_time{};
+  std::chrono::milliseconds _processing_time{};
 
-  friend class TecplotReader;
+  friend class TecplotFileLoader;
+  friend class TecplotBinaryFileLoader;
 
-  [[nodiscard]] bool x_is_full() const {
-    return _x.size() >= _n_verts.value();
+  [[nodiscard]] bool verts_is_full() const {
+    return _verts_cursor.is_full(_n_verts.value());
   }
 
-  [[nodiscard]] bool y_is_full() const {
-    return _y.size() >= _n_verts.value();
-  }
-
-  [[nodiscard]] bool z_is_full() const {
-    return _z.size() >= _n_verts.value();
-  }
-
-  [[nodiscard]] bool current_mx_is_full() const {
-    return _mx[_current_field_idx.value()].size() >= _n_verts.value();
-  };
-
-  [[nodiscard]] bool current_my_is_full() const {
-    return _my[_current_field_idx.value()].size() >= _n_verts.value();
-  }
-
-  [[nodiscard]] bool current_mz_is_full() const {
-    return _mz[_current_field_idx.value()].size() >= _n_verts.value();
+  [[nodiscard]] bool field_is_full(size_t field_idx) const {
+    return _field_cursors[field_idx].is_full(_n_verts.value());
   }
 
   [[nodiscard]] bool tetra_submesh_idx_is_full() const {
@@ -280,7 +290,7 @@ class TecplotData {
   }
 
   [[nodiscard]] bool tetra_idx_is_full() const {
-    return _tetra_idxs.size() >= _n_elems.value() * 4;
+    return _n_tetra_idx_values >= _n_elems.value() * 4;
   }
 
   void finish_object() {
@@ -294,27 +304,127 @@ class TecplotData {
   void validate_object() {
 
     // The number of vertices must be consistent.
-    if (_n_verts.value() != _x.size()) throw XCountException();
-    if (_n_verts.value() != _y.size()) throw YCountException();
-    if (_n_verts.value() != _z.size()) throw ZCountException();
+    if (_n_verts.value() != 0) {
+      if (_verts_cursor.component < 1) throw XCountException();
+      if (_verts_cursor.component < 2) throw YCountException();
+      if (_verts_cursor.component < 3) throw ZCountException();
+    }
 
     // The number of elements must be consistent.
-    if (4*_n_elems.value() != _tetra_idxs.size()) throw TetraIdxCountException();
+    if (4*_n_elems.value() != _n_tetra_idx_values) throw TetraIdxCountException();
     if (_n_elems.value() != _tetra_submesh_idxs.size()) throw TetraSubmeshIdxCountException();
 
-    // Check that the number of zones is consistent.
-    if (_n_zones.value() != _mx.size()) throw MxZoneCountException();
-    if (_n_zones.value() != _my.size()) throw MyZoneCountException();
-    if (_n_zones.value() != _mz.size()) throw MzZoneCountException();
+    // Check that the number of zones is consistent. The field block holds
+    // the x, y and z components of a zone together, so this one check also
+    // covers the y and z zone counts.
+    if (_n_zones.value() != _field_block.n_zones()) throw MxZoneCountException();
+
+    if (_n_verts.value() != 0) {
+      for (const auto &cursor : _field_cursors) {
+        if (cursor.component < 1) throw MxComponentCountException();
+        if (cursor.component < 2) throw MyComponentCountException();
+        if (cursor.component < 3) throw MzComponentCountException();
+      }
+    }
+
+  }
+
+};
+
+/**
+ * Field source that decodes the zones of a memory mapped tecplot file.
+ */
+class TecplotZoneSource : public FieldSource {
+
+ public:
+
+  /**
+   * Create a new source.
+   * @param mapped_file the mapped tecplot file.
+   * @param zones the locations of the zones within the mapped file.
+   * @param n_verts the number of vertices in each zone.
+   */
+  TecplotZoneSource(std::shared_ptr<const MappedFile> mapped_file,
+                    const std::vector<TecplotScanner::ZoneSpan> &zones,
+                    size_t n_verts) :
+      _mapped_file{std::move(mapped_file)},
+      _n_verts{n_verts} {
+
+    _bodies.reserve(zones.size());
+    _titles.reserve(zones.size());
+    for (const auto &zone : zones) {
+      _bodies.push_back(zone.body);
+      _titles.emplace_back(zone.header.title);
+    }
+
+  }
+
+  [[nodiscard]] size_t
+  n_fields() const override { return _bodies.size(); }
+
+  [[nodiscard]] Field
+  load(size_t index) const override {
+
+    auto block = std::make_shared<FieldBlock>(_n_verts, 1);
+    TecplotData::BlockCursor cursor;
+
+    // The first zone starts with the vertex coordinates.
+    size_t n_skip = index == 0 ? 3 * _n_verts : 0;
+    size_t count = 0;
+
+    TecplotScanner::for_each_line(_bodies.at(index), [&](std::string_view line) {
+
+      TecplotScanner::ZoneHeader header{};
 
-    for (size_t i = 0; i < _n_zones; ++i) {
-      if (_mx[i].size() != _n_verts.value()) throw MxComponentCountException();
-      if (_my[i].size() != _n_verts.value()) throw MyComponentCountException();
-      if (_mz[i].size() != _n_verts.value()) throw MzComponentCountException();
+      switch (TecplotScanner::classify(line, header)) {
+        case TecplotScanner::LineType::IntLine:
+          // Connectivity is only found in (and already read from) zone one.
+          if (index != 0) {
+            throw std::runtime_error(
+                "Integers should only be found in the first zone.");
+          }
+          break;
+        case TecplotScanner::LineType::FloatLine:
+          TecplotScanner::for_each_double(line, [&](double value) {
+            if (count < n_skip) {
+              count++;
+            } else if (!cursor.is_full(_n_verts)) {
+              cursor.put(*block, 0, value);
+            } else {
+              throw std::runtime_error("Too many doubles for zone.");
+            }
+          });
+          break;
+        default:
+          break;
+      }
+
+    });
+
+    if (_n_verts != 0) {
+      if (cursor.component < 1) throw TecplotData::MxComponentCountException();
+      if (cursor.component < 2) throw TecplotData::MyComponentCountException();
+      if (cursor.component < 3) throw TecplotData::MzComponentCountException();
     }
 
+    return Field{_titles[index], std::move(block), 0};
+
   }
 
+ private:
+
+  // The mapped tecplot file, this keeps the zone bodies valid.
+  std::shared_ptr<const MappedFile> _mapped_file;
+
+  // The body of each zone.
+  std::vector<std::string_view> _bodies;
+
+  // The title of each zone.
+  std::vector<std::string> _titles;
+
+  // The number of vertices in each zone.
+  size_t _n_verts;
+
 };
 
 /**
@@ -330,247 +440,440 @@ class TecplotFileLoader {
   TecplotFileLoader() = default;
 
   /**
- * Function that will read a file and produce a Model object.
- * @param file_name the name of the file.
- * @return a new model object, this object will only contain Mesh information.
- */
+   * The ways in which a tecplot file can be read.
+   */
+  enum class ReadMode {
+    // Memory map the file if possible, otherwise fall back to a stream.
+    Automatic,
+    // Memory map the file, fail if the file can not be mapped.
+    Mapped,
+    // Read the file line by line through a stream.
+    Stream
+  };
+
+  /**
+   * The time spent in each phase of a read, used for benchmarking.
+   */
+  struct Timings {
+    // Mapping (or opening) the file.
+    std::chrono::nanoseconds open{};
+    // Locating the zones of a mapped file.
+    std::chrono::nanoseconds zone_scan{};
+    // Splitting and classifying lines and converting numbers.
+    std::chrono::nanoseconds parse{};
+    // Validating the parsed data.
+    std::chrono::nanoseconds validation{};
+    // Moving the parsed data in to a Model.
+    std::chrono::nanoseconds construction{};
+  };
+
+  /**
+   * Function that will read a file and produce a Model object.
+   * @param file_name the name of the file.
+   * @param mode the way in which the file is read.
+   * @param n_threads the number of threads used to parse zones of a mapped
+   *                  file, zero means one per core.
+   * @param progress optional progress reporting and cancellation.
+   * @param timings optional output for the time spent in each phase.
+   * @return a new model object, this object will only contain Mesh information.
+   */
   static Model
-  read(const std::string &file_name) {
+  read(const std::string &file_name,
+       ReadMode mode = ReadMode::Automatic,
+       size_t n_threads = 0,
+       LoadProgress *progress = nullptr,
+       Timings *timings = nullptr) {
+
+    using clock = std::chrono::high_resolution_clock;
 
     TecplotData curves;
+    Timings local_timings;
+    if (!timings) timings = &local_timings;
+
+    auto start = clock::now();
+
+    std::optional<MappedFile> mapped_file;
+    if (mode != ReadMode::Stream) {
+      mapped_file.emplace(file_name);
+      if (!mapped_file->is_mapped()) {
+        if (mode == ReadMode::Mapped) {
+          throw TecplotFileLoaderException(
+              "Could not memory map the file '" + file_name + "'.");
+        }
+        mapped_file.reset();
+      }
+    }
 
-    std::string line;
-    std::fstream fin(file_name);
+    auto opened = clock::now();
+    timings->open = opened - start;
 
-    size_t zone_counter = 0;
+    if (mapped_file.has_value()) {
+      if (progress) progress->start("Parsing", mapped_file->size());
+      read_buffer(curves, mapped_file->view(), n_threads, progress, timings);
+    } else {
+      read_stream(curves, file_name, progress);
+      timings->zone_scan = {};
+    }
 
-    std::regex _regex_zone = new_regex_zone();
-    std::regex _regex_float_line = new_regex_float_line();
-    std::regex _regex_int_line = new_regex_int_line();
+    auto parsed = clock::now();
+    timings->parse = parsed - opened - timings->zone_scan;
 
-    std::smatch match_zone;
-    std::smatch match_zone_title;
-    std::smatch match_int_line;
-    std::smatch match_float_line;
+    curves._processing_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(parsed - start);
 
-    auto start = std::chrono::high_resolution_clock::now();
+    curves.finish_object();
 
-    while (std::getline(fin, line)) {
+    auto validated = clock::now();
+    timings->validation = validated - parsed;
 
-      //////////////////////////////////////////////////////////////////////////
-      // Handle matching a 'ZONE' line.                                       //
-      //////////////////////////////////////////////////////////////////////////
+    Model model{
+        curves.take_verts(),
+        curves.take_elements(),
+        curves.take_submesh_idxs(),
+        curves.take_fields()
+    };
 
-      if (std::regex_match(line, match_zone, _regex_zone)) {
+    timings->construction = clock::now() - validated;
 
-        std::string str_n_verts = match_zone[2].str();
-        std::string str_n_elems = match_zone[3].str();
+    return model;
 
-        zone_counter++;
+  }
 
-        std::cout << "Processing zone: " << zone_counter << " " << std::endl;
+  /**
+   * Function that will read a file and produce a Model object whose fields
+   * are loaded lazily. Only the geometry and the first zone are parsed up
+   * front, the file stays mapped and the remaining zones are decoded from it
+   * the first time they are asked for.
+   * @param file_name the name of the file, this must be memory mappable.
+   * @param max_resident the maximum number of decoded zones kept in memory.
+   * @param progress optional progress reporting and cancellation.
+   * @return a new model object with a lazy field list.
+   */
+  static Model
+  read_lazy(const std::string &file_name,
+            size_t max_resident = FieldList::default_max_resident,
+            LoadProgress *progress = nullptr) {
 
-        if (zone_counter == 1) {
+    auto start = std::chrono::high_resolution_clock::now();
 
-          // this is the first zone.
+    auto mapped_file = std::make_shared<const MappedFile>(file_name);
+    if (!mapped_file->is_mapped()) {
+      throw TecplotFileLoaderException(
+          "Could not memory map the file '" + file_name + "'.");
+    }
 
-          curves._n_verts = std::stoi(str_n_verts);
-          curves._n_elems = std::stoi(str_n_elems);
+    std::string_view prelude;
+    auto zones = TecplotScanner::find_zones(mapped_file->view(), prelude);
+    if (zones.empty()) {
+      throw TecplotFileLoaderException(
+          "The file '" + file_name + "' does not contain any zones.");
+    }
 
-          curves._tetra_idxs.reserve(4 * curves._n_elems.value());
-          curves._tetra_submesh_idxs.reserve(curves._n_elems.value());
+    if (progress) {
+      progress->start("Parsing", prelude.size() + zones.front().body.size());
+    }
 
-          curves._x.reserve(curves._n_verts.value());
-          curves._y.reserve(curves._n_verts.value());
-          curves._z.reserve(curves._n_verts.value());
+    TecplotData curves;
 
-          curves._current_field_idx = 0;
-          curves._mx.emplace_back();
-          curves._my.emplace_back();
-          curves._mz.emplace_back();
+    size_t zone_counter = 0;
+    read_lines(curves, zone_counter, prelude, progress);
 
-          curves._mx[curves._current_field_idx.value()].reserve(curves._n_verts.value());
-          curves._my[curves._current_field_idx.value()].reserve(curves._n_verts.value());
-          curves._mz[curves._current_field_idx.value()].reserve(curves._n_verts.value());
+    // Geometry and the first field.
+    read_zone_line(curves, zone_counter, zones.front().header);
+    read_lines(curves, zone_counter, zones.front().body, progress);
 
-        } else {
+    // The remaining zones are only indexed.
+    for (size_t i = 1; i < zones.size(); ++i) {
+      check_zone_header(curves, zones[i].header);
+    }
 
-          // This is not the first zone.
+    curves.finish_object();
 
-          if ((!curves._n_verts.has_value())
-              && (!curves._n_elems.has_value())) {
-            throw std::runtime_error(
-                "Parsing subsequent zone, but no. of vertices/elements is not set.");
-          } else {
-            if (curves._n_verts.value() != std::stoi(str_n_verts)) {
-              throw std::runtime_error("Unexpected number of vertices in zone.");
-            }
-            if (curves._n_elems.value() != std::stoi(str_n_elems)) {
-              throw std::runtime_error("Unexpected number of elements in zone.");
-            }
-          }
+    FieldList field_list{
+        std::make_shared<TecplotZoneSource>(mapped_file, zones, curves.n_verts()),
+        max_resident
+    };
+    field_list.preload(0, curves.take_fields().fields().front());
+
+    auto stop = std::chrono::high_resolution_clock::now();
 
-          curves._current_field_idx.value()++;
-          curves._mx.emplace_back();
-          curves._my.emplace_back();
-          curves._mz.emplace_back();
+    curves._processing_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
 
-          curves._mx[curves._current_field_idx.value()].reserve(curves._n_verts.value());
-          curves._my[curves._current_field_idx.value()].reserve(curves._n_verts.value());
-          curves._mz[curves._current_field_idx.value()].reserve(curves._n_verts.value());
+    return {
+        curves.take_verts(),
+        curves.take_elements(),
+        curves.take_submesh_idxs(),
+        std::move(field_list)
+    };
 
-        }
+  }
+
+ private:
 
-        // Process the ZONE title that contains Br & Bb field values.
+  // Number of bytes parsed between progress reports/cancellation checks.
+  static constexpr size_t progress_granularity = 1 << 20;
 
-        std::string str_zone_title = match_zone[1].str();
+  /**
+   * Read tecplot data line by line from a stream, this works for pipes and
+   * other inputs that can not be memory mapped.
+   * @param curves the tecplot data that is being populated.
+   * @param file_name the name of the file.
+   * @param progress optional progress reporting and cancellation.
+   */
+  static void
+  read_stream(TecplotData &curves, const std::string &file_name, LoadProgress *progress) {
 
-        curves._zone_titles.push_back(str_zone_title);
+    std::string line;
+    std::ifstream fin(file_name);
 
-        continue;
+    if (progress) {
+      // The size of pipes and other special files is unknown.
+      std::error_code ec;
+      bool is_regular = std::filesystem::is_regular_file(file_name, ec);
+      progress->start("Parsing", is_regular ? std::filesystem::file_size(file_name, ec) : 0);
+    }
 
+    size_t zone_counter = 0;
+    size_t pending_bytes = 0;
+
+    while (std::getline(fin, line)) {
+      read_line(curves, zone_counter, line);
+      if (progress && (pending_bytes += line.size() + 1) >= progress_granularity) {
+        progress->advance(pending_bytes);
+        pending_bytes = 0;
       }
+    }
 
-      //////////////////////////////////////////////////////////////////////////////////////////////////////
-      // Handle matching a line of integer values.                                                        //
-      //////////////////////////////////////////////////////////////////////////////////////////////////////
+    if (progress) progress->advance(pending_bytes);
 
-      if (std::regex_match(line, match_int_line, _regex_int_line)) {
+  }
 
-        std::vector<std::string> str_values = regex_split(line);
+  /**
+   * Read tecplot data from an in-memory buffer, lines are handed to the
+   * parser as views in to the buffer so nothing is copied. The buffer is
+   * read in two phases: a pre-scan locates every 'ZONE' line, after which
+   * the zones (which are independent once the number of vertices/elements
+   * is known) are parsed concurrently, each in to its own field vectors.
+   * @param curves the tecplot data that is being populated.
+   * @param buffer the buffer.
+   * @param n_threads the number of threads, zero means one per core.
+   * @param progress optional progress reporting and cancellation.
+   * @param timings output for the time spent locating zones.
+   */
+  static void
+  read_buffer(TecplotData &curves,
+              std::string_view buffer,
+              size_t n_threads,
+              LoadProgress *progress,
+              Timings *timings) {
 
-        if (zone_counter == 1) {
+    auto start = std::chrono::high_resolution_clock::now();
 
-          for (const auto &str_value : str_values) {
-            if (!str_value.empty()) {
-              if (!curves.tetra_submesh_idx_is_full()) {
-                curves._tetra_submesh_idxs.push_back(std::stoull(str_value));
-              } else if (!curves.tetra_idx_is_full()) {
-                curves._tetra_idxs.push_back(std::stoull(str_value) - 1);
-              } else {
-                throw std::runtime_error("Too many integers for zone.");
-              }
-            }
-          }
+    std::string_view prelude;
+    auto zones = TecplotScanner::find_zones(buffer, prelude);
 
-        } else {
+    timings->zone_scan = std::chrono::high_resolution_clock::now() - start;
 
-          // This is not the first zone.
-          throw std::runtime_error(
-              "Integers should only be found in the first zone.");
+    size_t zone_counter = 0;
+    read_lines(curves, zone_counter, prelude, progress);
 
-        }
+    // Zone headers are validated in file order and the field vectors are
+    // allocated up front, so that workers never resize shared containers.
+    curves._field_cursors.reserve(zones.size());
+    for (const auto &zone : zones) {
+      read_zone_line(curves, zone_counter, zone.header, zones.size());
+    }
 
-        continue;
+    parallel_for(zones.size(), [&curves, &zones, progress](size_t zone_idx) {
+      size_t body_zone_counter = zone_idx + 1;
+      read_lines(curves, body_zone_counter, zones[zone_idx].body, progress);
+    }, n_threads);
 
+  }
+
+  /**
+   * Process each line of a buffer.
+   * @param curves the tecplot data that is being populated.
+   * @param zone_counter the number of zones seen so far.
+   * @param buffer the buffer.
+   * @param progress optional progress reporting and cancellation.
+   */
+  static void
+  read_lines(TecplotData &curves,
+             size_t &zone_counter,
+             std::string_view buffer,
+             LoadProgress *progress = nullptr) {
+
+    size_t pending_bytes = 0;
+
+    TecplotScanner::for_each_line(buffer, [&](std::string_view line) {
+      read_line(curves, zone_counter, line);
+      if (progress && (pending_bytes += line.size() + 1) >= progress_granularity) {
+        progress->advance(pending_bytes);
+        pending_bytes = 0;
       }
+    });
 
-      //////////////////////////////////////////////////////////////////////////////////////////////////////
-      // Handle matching a line of floating point values.                                                 //
-      //////////////////////////////////////////////////////////////////////////////////////////////////////
-
-      if (std::regex_match(line, match_float_line, _regex_float_line)) {
-
-//      std::cout << "FLOAT LINE: " << line << "\n";
-
-        std::vector<std::string> str_values = regex_split(line);
-
-        if (zone_counter == 1) {
-
-          // This is the first zone.
-
-          for (const auto &str_value : str_values) {
-            if (!str_value.empty()) {
-              if (!curves.x_is_full()) {
-                curves._x.push_back(std::stod(str_value));
-              } else if (!curves.y_is_full()) {
-                curves._y.push_back(std::stod(str_value));
-              } else if (!curves.z_is_full()) {
-                curves._z.push_back(std::stod(str_value));
-              } else if (!curves.current_mx_is_full()) {
-                curves._mx[curves._current_field_idx.value()].push_back(
-                    std::stod(str_value));
-              } else if (!curves.current_my_is_full()) {
-                curves._my[curves._current_field_idx.value()].push_back(
-                    std::stod(str_value));
-              } else if (!curves.current_mz_is_full()) {
-                curves._mz[curves._current_field_idx.value()].push_back(
-                    std::stod(str_value));
-              } else {
-                throw std::runtime_error("Too many doubles for zone.");
-              }
-            }
-          }
+    if (progress) progress->advance(pending_bytes);
 
-        } else {
-
-          // This is not the first zone.
-
-          for (const auto &str_value : str_values) {
-            if (!str_value.empty()) {
-              if (!curves.current_mx_is_full()) {
-                curves._mx[curves._current_field_idx.value()].push_back(
-                    std::stod(str_value));
-              } else if (!curves.current_my_is_full()) {
-                curves._my[curves._current_field_idx.value()].push_back(
-                    std::stod(str_value));
-              } else if (!curves.current_mz_is_full()) {
-                curves._mz[curves._current_field_idx.value()].push_back(
-                    std::stod(str_value));
-              } else {
-                throw std::runtime_error("Too many doubles for zone.");
-              }
-            }
-          }
+  }
 
-        }
+  /**
+   * Process a single line of a tecplot file.
+   * @param curves the tecplot data that is being populated.
+   * @param zone_counter the number of zones seen so far.
+   * @param line the line.
+   */
+  static void
+  read_line(TecplotData &curves, size_t &zone_counter, std::string_view line) {
+
+    TecplotScanner::ZoneHeader header{};
+
+    switch (TecplotScanner::classify(line, header)) {
+      case TecplotScanner::LineType::Zone:
+        read_zone_line(curves, zone_counter, header);
+        break;
+      case TecplotScanner::LineType::IntLine:
+        read_int_line(curves, zone_counter, line);
+        break;
+      case TecplotScanner::LineType::FloatLine:
+        read_float_line(curves, zone_counter, line);
+        break;
+      case TecplotScanner::LineType::Other:
+        break;
+    }
 
-        continue;
+  }
 
-      }
+  //////////////////////////////////////////////////////////////////////////
+  // Handle matching a 'ZONE' line.                                       //
+  //////////////////////////////////////////////////////////////////////////
 
-    }
+  static void
+  read_zone_line(TecplotData &curves,
+                 size_t &zone_counter,
+                 const TecplotScanner::ZoneHeader &header,
+                 size_t n_zones_hint = 0) {
 
-    auto stop = std::chrono::high_resolution_clock::now();
+    zone_counter++;
 
-    curves._processing_time =
-        std::chrono::duration_cast<std::chrono::minutes>(stop - start);
+    if (zone_counter == 1) {
 
-    curves.finish_object();
+      // this is the first zone.
 
-    return {
-        curves.get_verts(),
-        curves.get_elements(),
-        curves.get_submesh_idxs(),
-        curves.get_fields()
-    };
+      curves._n_verts = header.n_verts;
+      curves._n_elems = header.n_elems;
 
-  }
+      curves._tetra_idxs = Connectivity::for_vertices(curves._n_verts.value(), curves._n_elems.value());
+      curves._tetra_submesh_idxs.reserve(curves._n_elems.value());
 
- private:
+      curves._verts.resize(curves._n_verts.value());
+
+      // When the number of zones is known the block is allocated once, at
+      // its final size.
+      curves._field_block = FieldBlock{curves._n_verts.value()};
+      curves._field_block.reserve(n_zones_hint);
+
+      curves._current_field_idx = 0;
+
+    } else {
+
+      // This is not the first zone.
+
+      check_zone_header(curves, header);
+
+      curves._current_field_idx.value()++;
+
+    }
+
+    curves._field_block.resize(curves._field_block.n_zones() + 1);
+    curves._field_cursors.emplace_back();
+
+    // Process the ZONE title that contains Br & Bb field values.
+
+    curves._zone_titles.emplace_back(header.title);
+
+  }
 
   /**
-   * Return a regular expression that will match a zone line.
+   * Check that the header of a subsequent zone agrees with the first zone.
+   * @param curves the tecplot data that is being populated.
+   * @param header the header of the zone.
    */
-  static std::regex
-  new_regex_zone() {
-    return std::regex{
-        R"r(^\s*ZONE\s*T\s*=\s*"([A-Za-z0-9=\-.,;\s]+)?"\s*,?\s*N\s*=\s*([0-9]+)\s*,?\s*E\s*=\s*([0-9]+)\s*$)r"
-    };
+  static void
+  check_zone_header(const TecplotData &curves,
+                    const TecplotScanner::ZoneHeader &header) {
+
+    if ((!curves._n_verts.has_value())
+        && (!curves._n_elems.has_value())) {
+      throw std::runtime_error(
+          "Parsing subsequent zone, but no. of vertices/elements is not set.");
+    } else {
+      if (curves._n_verts.value() != header.n_verts) {
+        throw std::runtime_error("Unexpected number of vertices in zone.");
+      }
+      if (curves._n_elems.value() != header.n_elems) {
+        throw std::runtime_error("Unexpected number of elements in zone.");
+      }
+    }
+
   }
 
-  static std::regex
-  new_regex_int_line() {
-    return std::regex{
-        R"r(^\s*([0-9]+)(\s+[0-9]+)*\s*$)r"
-    };
+  //////////////////////////////////////////////////////////////////////////
+  // Handle matching a line of integer values.                            //
+  //////////////////////////////////////////////////////////////////////////
+
+  static void
+  read_int_line(TecplotData &curves, size_t zone_counter, std::string_view line) {
+
+    if (zone_counter != 1) {
+      // This is not the first zone.
+      throw std::runtime_error(
+          "Integers should only be found in the first zone.");
+    }
+
+    TecplotScanner::for_each_int(line, [&curves](size_t value) {
+      if (!curves.tetra_submesh_idx_is_full()) {
+        curves._tetra_submesh_idxs.push_back(value);
+      } else if (!curves.tetra_idx_is_full()) {
+        size_t i = curves._n_tetra_idx_values++;
+        curves._tetra_idxs.set(i / 4, i % 4, value - 1);
+      } else {
+        throw std::runtime_error("Too many integers for zone.");
+      }
+    });
+
   }
 
-  static std::regex
-  new_regex_float_line() {
-    return std::regex{
-        R"r(^\s*([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?)(\s+([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?))*\s*$)r"
-    };
+  //////////////////////////////////////////////////////////////////////////
+  // Handle matching a line of floating point values.                     //
+  //////////////////////////////////////////////////////////////////////////
+
+  static void
+  read_float_line(TecplotData &curves, size_t zone_counter, std::string_view line) {
+
+    if (zone_counter == 0) {
+      throw std::runtime_error(
+          "Floating point values found before the first zone.");
+    }
+
+    // Only the first zone contains vertex coordinates.
+    bool first_zone = zone_counter == 1;
+    size_t field_idx = zone_counter - 1;
+
+    auto &field_cursor = curves._field_cursors[field_idx];
+
+    TecplotScanner::for_each_double(line, [&](double value) {
+      if (first_zone && !curves.verts_is_full()) {
+        curves._verts_cursor.put(curves._verts, value);
+      } else if (!curves.field_is_full(field_idx)) {
+        field_cursor.put(curves._field_block, field_idx, value);
+      } else {
+        throw std::runtime_error("Too many doubles for zone.");
+      }
+    });
+
   }
 
 };
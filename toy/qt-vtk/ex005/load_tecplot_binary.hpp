@@ -0,0 +1,644 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_LOAD_TECPLOT_BINARY_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_LOAD_TECPLOT_BINARY_HPP_
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "field.hpp"
+#include "load_progress.hpp"
+#include "load_tecplot.hpp"
+#include "mapped_file.hpp"
+#include "model.hpp"
+#include "parallel.hpp"
+
+/**
+ * Class to load a binary tecplot file ('*.plt', format version 112). The file
+ * must hold the same data as the ASCII files, i.e. the variables
+ *   X, Y, Z, Mx, My, Mz, SD
+ * in FEBLOCK tetrahedral zones, where SD (the sub-mesh index) is cell
+ * centred. The first zone holds the geometry and connectivity, subsequent
+ * zones are expected to share these with the first zone.
+ *
+ * The file is memory mapped and the bulk data is copied straight out of the
+ * mapping, there is no text to parse. Field components stored with the
+ * same precision as field_scalar have the same layout as a FieldBlock row
+ * and are copied with a single memcpy. Zones are decoded concurrently.
+ */
+class TecplotBinaryFileLoader {
+
+ public:
+
+  /**
+   * Function that will read a file and produce a Model object.
+   * @param file_name the name of the file.
+   * @param n_threads the number of threads used to decode zones, zero means
+   *                  one per core.
+   * @param progress optional progress reporting and cancellation.
+   * @return a new model object.
+   */
+  static Model
+  read(const std::string &file_name,
+       size_t n_threads = 0,
+       LoadProgress *progress = nullptr) {
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (file_name.ends_with(".szplt")) {
+      throw TecplotFileLoaderException(
+          "SZL (*.szplt) files are not supported, save the data as a '*.plt' file.");
+    }
+
+    MappedFile mapped_file{file_name};
+    if (!mapped_file.is_mapped()) {
+      throw TecplotFileLoaderException(
+          "Could not memory map the file '" + file_name + "'.");
+    }
+
+    Reader reader{mapped_file.view()};
+
+    size_t n_vars = read_header(reader);
+    std::vector<ZoneHeader> headers = read_zone_headers(reader, n_vars);
+    std::vector<ZoneData> zones = read_zone_layouts(reader, headers, n_vars);
+
+    if (zones.empty()) {
+      throw TecplotFileLoaderException(
+          "The file '" + file_name + "' does not contain any zones.");
+    }
+
+    TecplotData curves;
+    setup_data(curves, headers);
+
+    if (progress) {
+      size_t n_bytes = 0;
+      for (const auto &zone : zones) n_bytes += zone.n_bytes;
+      progress->start("Reading", n_bytes);
+    }
+
+    // Geometry and connectivity come from the first zone.
+    read_geometry(curves, headers.front(), zones.front());
+
+    parallel_for(zones.size(), [&curves, &headers, &zones, progress](size_t zone_idx) {
+      read_field(curves, zone_idx, headers[zone_idx], zones[zone_idx]);
+      if (progress) progress->advance(zones[zone_idx].n_bytes);
+    }, n_threads);
+
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    curves._processing_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+
+    curves.finish_object();
+
+    return {
+        curves.take_verts(),
+        curves.take_elements(),
+        curves.take_submesh_idxs(),
+        curves.take_fields()
+    };
+
+  }
+
+ private:
+
+  // Header section markers.
+  static constexpr float zone_marker = 299.0f;
+  static constexpr float geometry_marker = 399.0f;
+  static constexpr float text_marker = 499.0f;
+  static constexpr float custom_label_marker = 599.0f;
+  static constexpr float user_record_marker = 699.0f;
+  static constexpr float dataset_aux_marker = 799.0f;
+  static constexpr float variable_aux_marker = 899.0f;
+  static constexpr float end_of_header_marker = 357.0f;
+
+  // The zone type of tetrahedral finite element zones.
+  static constexpr int32_t fe_tetrahedron = 4;
+
+  // The location of cell centred variables.
+  static constexpr int32_t cell_centred = 1;
+
+  // Variable data formats.
+  enum DataFormat : int32_t {
+    Float = 1,
+    Double = 2,
+    LongInt = 3,
+    ShortInt = 4,
+    Byte = 5,
+    Bit = 6
+  };
+
+  // The data format that matches the precision of a FieldBlock.
+  static constexpr int32_t field_format = std::is_same_v<field_scalar, float> ? Float : Double;
+
+  // The variables used by the model, and the minimum number of variables.
+  static constexpr size_t var_x = 0;
+  static constexpr size_t var_mx = 3;
+  static constexpr size_t var_sd = 6;
+  static constexpr size_t n_model_vars = 7;
+
+  /**
+   * Bounds checked cursor over the bytes of the file.
+   */
+  class Reader {
+
+   public:
+
+    explicit Reader(std::string_view buffer) : _buffer{buffer} {}
+
+    [[nodiscard]] const char *
+    take(size_t n_bytes) {
+
+      if (n_bytes > _buffer.size() - _offset) {
+        throw TecplotFileLoaderException("Unexpected end of binary tecplot file.");
+      }
+
+      const char *data = _buffer.data() + _offset;
+      _offset += n_bytes;
+
+      return data;
+
+    }
+
+    [[nodiscard]] const char *
+    position() const { return _buffer.data() + _offset; }
+
+    template<typename T>
+    [[nodiscard]] T
+    value() {
+
+      T result;
+      std::memcpy(&result, take(sizeof(T)), sizeof(T));
+
+      return result;
+
+    }
+
+    /**
+     * Read a string, these are stored as one INT32 per character and are
+     * terminated by a zero.
+     */
+    [[nodiscard]] std::string
+    string() {
+
+      std::string result;
+      for (auto c = value<int32_t>(); c != 0; c = value<int32_t>()) {
+        result.push_back((char) c);
+      }
+
+      return result;
+
+    }
+
+   private:
+
+    std::string_view _buffer;
+
+    size_t _offset{0};
+
+  };
+
+  /**
+   * The parts of a zone header that are needed to locate its data.
+   */
+  struct ZoneHeader {
+    std::string title;
+    std::vector<int32_t> var_location;
+    size_t n_verts;
+    size_t n_elems;
+    int32_t n_misc_face_neighbours;
+  };
+
+  /**
+   * The location of the data of a zone within the file, variables that are
+   * shared or passive have no data.
+   */
+  struct ZoneData {
+    std::vector<int32_t> formats;
+    std::vector<const char *> vars;
+    const char *connectivity;
+    size_t n_bytes;
+  };
+
+  /**
+   * Read the file header, up to and including the variable names.
+   * @param reader the reader.
+   * @return the number of variables.
+   */
+  static size_t
+  read_header(Reader &reader) {
+
+    std::string_view magic{reader.take(8), 8};
+    if (!magic.starts_with("#!TDV")) {
+      throw TecplotFileLoaderException("The file is not a binary tecplot file.");
+    }
+    if (magic != "#!TDV112") {
+      throw TecplotFileLoaderException(
+          "Unsupported binary tecplot version '" + std::string(magic.substr(2)) + "'.");
+    }
+
+    if (reader.value<int32_t>() != 1) {
+      throw TecplotFileLoaderException(
+          "The binary tecplot file was written with a different byte order.");
+    }
+
+    // File type and title.
+    (void) reader.value<int32_t>();
+    (void) reader.string();
+
+    auto n_vars = reader.value<int32_t>();
+    if (n_vars < (int32_t) n_model_vars) {
+      throw TecplotFileLoaderException(
+          "Expected the variables X, Y, Z, Mx, My, Mz and SD.");
+    }
+    for (int32_t i = 0; i < n_vars; ++i) {
+      (void) reader.string();
+    }
+
+    return (size_t) n_vars;
+
+  }
+
+  /**
+   * Read the remainder of the header section.
+   * @param reader the reader.
+   * @param n_vars the number of variables.
+   * @return the zone headers.
+   */
+  static std::vector<ZoneHeader>
+  read_zone_headers(Reader &reader, size_t n_vars) {
+
+    std::vector<ZoneHeader> headers;
+
+    for (auto marker = reader.value<float>();
+         marker != end_of_header_marker;
+         marker = reader.value<float>()) {
+
+      if (marker == zone_marker) {
+        headers.push_back(read_zone_header(reader, n_vars));
+      } else if (marker == dataset_aux_marker) {
+        // Name, value format and value.
+        (void) reader.string();
+        (void) reader.value<int32_t>();
+        (void) reader.string();
+      } else if (marker == variable_aux_marker) {
+        // Variable, name, value format and value.
+        (void) reader.value<int32_t>();
+        (void) reader.string();
+        (void) reader.value<int32_t>();
+        (void) reader.string();
+      } else if (marker == custom_label_marker) {
+        auto n_labels = reader.value<int32_t>();
+        for (int32_t i = 0; i < n_labels; ++i) {
+          (void) reader.string();
+        }
+      } else if (marker == geometry_marker || marker == text_marker || marker == user_record_marker) {
+        throw TecplotFileLoaderException(
+            "Binary tecplot geometries, text and user records are not supported.");
+      } else {
+        throw TecplotFileLoaderException("Invalid binary tecplot header.");
+      }
+
+    }
+
+    return headers;
+
+  }
+
+  /**
+   * Read a single zone header, the zone marker has already been read.
+   * @param reader the reader.
+   * @param n_vars the number of variables.
+   * @return the zone header.
+   */
+  static ZoneHeader
+  read_zone_header(Reader &reader, size_t n_vars) {
+
+    ZoneHeader header{};
+
+    header.title = reader.string();
+
+    // Parent zone, strand id, solution time and (unused) zone colour.
+    (void) reader.value<int32_t>();
+    (void) reader.value<int32_t>();
+    (void) reader.value<double>();
+    (void) reader.value<int32_t>();
+
+    if (reader.value<int32_t>() != fe_tetrahedron) {
+      throw TecplotFileLoaderException("Only FETETRAHEDRON zones are supported.");
+    }
+
+    header.var_location.assign(n_vars, 0);
+    if (reader.value<int32_t>() != 0) {
+      for (auto &location : header.var_location) {
+        location = reader.value<int32_t>();
+      }
+    }
+
+    // Raw local face neighbours supplied.
+    (void) reader.value<int32_t>();
+
+    header.n_misc_face_neighbours = reader.value<int32_t>();
+    if (header.n_misc_face_neighbours != 0) {
+      // Face neighbour mode and whether the neighbours are complete.
+      (void) reader.value<int32_t>();
+      (void) reader.value<int32_t>();
+    }
+
+    auto n_verts = reader.value<int32_t>();
+    auto n_elems = reader.value<int32_t>();
+    if (n_verts < 0 || n_elems < 0) {
+      throw TecplotFileLoaderException("Invalid binary tecplot zone size.");
+    }
+    header.n_verts = (size_t) n_verts;
+    header.n_elems = (size_t) n_elems;
+
+    // I, J and K cell dimensions (unused).
+    (void) reader.value<int32_t>();
+    (void) reader.value<int32_t>();
+    (void) reader.value<int32_t>();
+
+    // Auxiliary name/value pairs.
+    while (reader.value<int32_t>() != 0) {
+      (void) reader.string();
+      (void) reader.value<int32_t>();
+      (void) reader.string();
+    }
+
+    return header;
+
+  }
+
+  /**
+   * Walk the data section and record where the data of each zone is, the
+   * data itself is not read.
+   * @param reader the reader.
+   * @param headers the zone headers.
+   * @param n_vars the number of variables.
+   * @return the location of the data of each zone.
+   */
+  static std::vector<ZoneData>
+  read_zone_layouts(Reader &reader,
+                    const std::vector<ZoneHeader> &headers,
+                    size_t n_vars) {
+
+    std::vector<ZoneData> zones;
+    zones.reserve(headers.size());
+
+    for (const auto &header : headers) {
+
+      if (reader.value<float>() != zone_marker) {
+        throw TecplotFileLoaderException("Invalid binary tecplot zone data.");
+      }
+
+      ZoneData zone{};
+
+      zone.formats.resize(n_vars);
+      for (auto &format : zone.formats) {
+        format = reader.value<int32_t>();
+      }
+
+      std::vector<int32_t> passive(n_vars, 0);
+      if (reader.value<int32_t>() != 0) {
+        for (auto &is_passive : passive) is_passive = reader.value<int32_t>();
+      }
+
+      std::vector<int32_t> shared(n_vars, -1);
+      if (reader.value<int32_t>() != 0) {
+        for (auto &share_zone : shared) share_zone = reader.value<int32_t>();
+      }
+
+      auto shared_connectivity = reader.value<int32_t>();
+
+      // Min/max of each variable that has data.
+      size_t n_with_data = 0;
+      for (size_t var = 0; var < n_vars; ++var) {
+        if (passive[var] == 0 && shared[var] == -1) n_with_data++;
+      }
+      (void) reader.take(2 * sizeof(double) * n_with_data);
+
+      const char *begin = reader.position();
+
+      zone.vars.assign(n_vars, nullptr);
+      for (size_t var = 0; var < n_vars; ++var) {
+        if (passive[var] != 0 || shared[var] != -1) continue;
+        size_t count = header.var_location[var] == cell_centred ? header.n_elems : header.n_verts;
+        zone.vars[var] = reader.take(value_bytes(zone.formats[var], count));
+      }
+
+      if (shared_connectivity == -1) {
+        if (header.n_misc_face_neighbours != 0) {
+          throw TecplotFileLoaderException(
+              "Binary tecplot face neighbour connections are not supported.");
+        }
+        zone.connectivity = reader.take(4 * sizeof(int32_t) * header.n_elems);
+      } else {
+        zone.connectivity = nullptr;
+      }
+
+      zone.n_bytes = (size_t) (reader.position() - begin);
+
+      zones.push_back(std::move(zone));
+
+    }
+
+    return zones;
+
+  }
+
+  /**
+   * Retrieve the number of bytes used by a block of values.
+   * @param format the data format of the values.
+   * @param count the number of values.
+   * @return the number of bytes.
+   */
+  static size_t
+  value_bytes(int32_t format, size_t count) {
+
+    switch (format) {
+      case Float: return sizeof(float) * count;
+      case Double: return sizeof(double) * count;
+      case LongInt: return sizeof(int32_t) * count;
+      case ShortInt: return sizeof(int16_t) * count;
+      case Byte: return sizeof(uint8_t) * count;
+      case Bit: return (count + 7) / 8;
+      default: throw TecplotFileLoaderException("Invalid binary tecplot data format.");
+    }
+
+  }
+
+  /**
+   * Call `fn(value)` for each value in a block.
+   * @param data the start of the block.
+   * @param format the data format of the values.
+   * @param count the number of values.
+   * @param fn the function to call with each value (as a double).
+   */
+  template<typename Fn>
+  static void
+  for_each_value(const char *data, int32_t format, size_t count, Fn &&fn) {
+
+    auto for_each = [&]<typename T>(T) {
+      for (size_t i = 0; i < count; ++i) {
+        T value;
+        std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+        fn((double) value);
+      }
+    };
+
+    switch (format) {
+      case Float: for_each(float{}); break;
+      case Double: for_each(double{}); break;
+      case LongInt: for_each(int32_t{}); break;
+      case ShortInt: for_each(int16_t{}); break;
+      case Byte: for_each(uint8_t{}); break;
+      case Bit:
+        for (size_t i = 0; i < count; ++i) {
+          fn((double) (((unsigned char) data[i / 8] >> (i % 8)) & 1));
+        }
+        break;
+      default: throw TecplotFileLoaderException("Invalid binary tecplot data format.");
+    }
+
+  }
+
+  /**
+   * Size the tecplot data according to the zone headers.
+   * @param curves the tecplot data that is being populated.
+   * @param headers the zone headers.
+   */
+  static void
+  setup_data(TecplotData &curves, const std::vector<ZoneHeader> &headers) {
+
+    const auto &first = headers.front();
+
+    if (first.var_location[var_x] == cell_centred
+        || first.var_location[var_x + 1] == cell_centred
+        || first.var_location[var_x + 2] == cell_centred) {
+      throw TecplotFileLoaderException("Vertex coordinates must be located at the nodes.");
+    }
+    if (first.var_location[var_sd] != cell_centred) {
+      throw TecplotFileLoaderException("Sub-mesh indices (SD) must be cell centred.");
+    }
+
+    curves._n_verts = first.n_verts;
+    curves._n_elems = first.n_elems;
+
+    curves._verts.resize(first.n_verts);
+    curves._tetra_idxs = Connectivity::for_vertices(first.n_verts, first.n_elems);
+    curves._tetra_submesh_idxs.reserve(first.n_elems);
+
+    curves._field_block = FieldBlock{first.n_verts, headers.size()};
+    curves._field_cursors.resize(headers.size());
+
+    for (const auto &header : headers) {
+
+      if (header.n_verts != first.n_verts) {
+        throw std::runtime_error("Unexpected number of vertices in zone.");
+      }
+      if (header.n_elems != first.n_elems) {
+        throw std::runtime_error("Unexpected number of elements in zone.");
+      }
+      for (size_t var = var_mx; var < var_mx + 3; ++var) {
+        if (header.var_location[var] == cell_centred) {
+          throw TecplotFileLoaderException("Field components must be located at the nodes.");
+        }
+      }
+
+      curves._zone_titles.push_back(header.title);
+
+    }
+
+  }
+
+  /**
+   * Read vertex coordinates, sub-mesh indices and connectivity from the
+   * first zone.
+   * @param curves the tecplot data that is being populated.
+   * @param header the header of the first zone.
+   * @param zone the data of the first zone.
+   */
+  static void
+  read_geometry(TecplotData &curves, const ZoneHeader &header, const ZoneData &zone) {
+
+    for (size_t var = var_x; var < var_x + 3; ++var) {
+      if (!zone.vars[var]) {
+        throw TecplotFileLoaderException("The first zone must contain the vertex coordinates.");
+      }
+      for_each_value(zone.vars[var], zone.formats[var], header.n_verts, [&curves](double value) {
+        curves._verts_cursor.put(curves._verts, value);
+      });
+    }
+
+    if (!zone.vars[var_sd]) {
+      throw TecplotFileLoaderException("The first zone must contain the sub-mesh indices.");
+    }
+    for_each_value(zone.vars[var_sd], zone.formats[var_sd], header.n_elems, [&curves](double value) {
+      curves._tetra_submesh_idxs.push_back((size_t) std::llround(value));
+    });
+
+    if (!zone.connectivity) {
+      throw TecplotFileLoaderException("The first zone must contain the connectivity.");
+    }
+
+    // Connectivity is stored 0-based, which is what the mesh uses.
+    size_t n_idxs = 4 * header.n_elems;
+    for (size_t i = 0; i < n_idxs; ++i) {
+      int32_t value;
+      std::memcpy(&value, zone.connectivity + i * sizeof(int32_t), sizeof(int32_t));
+      if (value < 0 || (size_t) value >= header.n_verts) {
+        throw TecplotFileLoaderException("Tetrahedron vertex index out of range.");
+      }
+      curves._tetra_idxs.set(i / 4, i % 4, (size_t) value);
+    }
+    curves._n_tetra_idx_values = n_idxs;
+
+  }
+
+  /**
+   * Read the field of a zone, this only touches data belonging to the zone
+   * so zones can be read concurrently.
+   * @param curves the tecplot data that is being populated.
+   * @param zone_idx the index of the zone.
+   * @param header the header of the zone.
+   * @param zone the data of the zone.
+   */
+  static void
+  read_field(TecplotData &curves,
+             size_t zone_idx,
+             const ZoneHeader &header,
+             const ZoneData &zone) {
+
+    auto &block = curves._field_block;
+    auto &cursor = curves._field_cursors[zone_idx];
+
+    for (size_t var = var_mx; var < var_mx + 3; ++var) {
+      if (!zone.vars[var]) {
+        throw TecplotFileLoaderException(
+            "Zone '" + header.title + "' does not contain the field components.");
+      }
+      if (zone.formats[var] == field_format) {
+        // The block has the same layout as the file, copy a whole component.
+        auto row = block.component(zone_idx, var - var_mx);
+        std::memcpy(row.data(), zone.vars[var], row.size_bytes());
+        cursor.component++;
+      } else {
+        for_each_value(zone.vars[var], zone.formats[var], header.n_verts, [&](double value) {
+          cursor.put(block, zone_idx, value);
+        });
+      }
+    }
+
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_LOAD_TECPLOT_BINARY_HPP_
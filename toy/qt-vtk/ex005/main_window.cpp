@@ -27,6 +27,15 @@ MainWindow::MainWindow() {
   // Additional GUI widget setup.
   _status_bar->showMessage("Current file: <None>");
 
+  _load_progress_bar = new QProgressBar(this);
+  _load_progress_bar->setMaximumWidth(200);
+  _load_progress_bar->setVisible(false);
+  _status_bar->addPermanentWidget(_load_progress_bar);
+
+  _btn_cancel_load = new QPushButton(tr("Cancel"), this);
+  _btn_cancel_load->setVisible(false);
+  _status_bar->addPermanentWidget(_btn_cancel_load);
+
   _renderer = _vtk_widget->renderWindow()->GetRenderers()->GetFirstRenderer();
   if (!_renderer) {
     std::cout << "There is no first renderer, so we create one." << std::endl;
@@ -73,6 +82,8 @@ MainWindow::MainWindow() {
           this, SLOT(slot_sli_ugrid_opacity_changed(int)));
   connect(_sli_vector_opacity, SIGNAL(valueChanged(int)),
           this, SLOT(slot_sli_vector_opacity_changed(int)));
+  connect(_lst_submeshes, SIGNAL(itemChanged(QListWidgetItem *)),
+          this, SLOT(slot_lst_submeshes_item_changed(QListWidgetItem *)));
 
   connect(_btn_mfm, SIGNAL(clicked(bool)),
           this, SLOT(slot_btn_mfm_clicked()));
@@ -84,10 +95,24 @@ MainWindow::MainWindow() {
   connect(_preferencesAction, &QAction::triggered,
           this, &MainWindow::slot_menu_preferences);
 
+  connect(_btn_cancel_load, &QPushButton::clicked,
+          this, &MainWindow::cancel_load);
+
   emit(_current_image->update_image());
 
 }
 
+MainWindow::~MainWindow() {
+
+  // Stop any load in progress, updates it has already posted are discarded
+  // along with this object.
+  if (_load_thread.has_value()) {
+    _load_thread->request_stop();
+    _load_thread.reset();
+  }
+
+}
+
 void
 MainWindow::slot_timer_timeout() {
 
@@ -109,8 +134,6 @@ MainWindow::slot_btn_load_tecplot_clicked() {
     return;
   }
 
-  clear_model();
-
   QFileInfo file_info{selected_file_name};
 
   QString abs_path = file_info.absolutePath();
@@ -118,26 +141,7 @@ MainWindow::slot_btn_load_tecplot_clicked() {
 
   settings.setValue(CONFIG_LAST_DATA_DIR, abs_path);
 
-  // Load tecplot file in to _model.
-  _model = TecplotFileLoader::read(
-      file_info.absoluteFilePath().toStdString()
-  );
-
-  _model->enable_graphics();
-  _model->set_arrow_scale(_txt_arrow_scale->text().toDouble());
-
-  show_arrow_actor();
-  show_ugrid_actor();
-
-  _chk_ugrid->setCheckState(Qt::CheckState::Checked);
-  _chk_vectors->setCheckState(Qt::CheckState::Checked);
-
-  populate_plane_parameters();
-
-  _status_bar->showMessage(tr("Current file: ") + file_info.absoluteFilePath());
-
-  _vtk_widget->update();
-  _vtk_widget->renderWindow()->Render();
+  start_load(file_info.absoluteFilePath());
 
 }
 
@@ -311,6 +315,19 @@ MainWindow::slot_sli_vector_opacity_changed(int value) {
 
 }
 
+void
+MainWindow::slot_lst_submeshes_item_changed(QListWidgetItem *item) {
+
+  if (!_model.has_value()) return;
+
+  auto index = item->data(Qt::UserRole).value<qulonglong>();
+  _model->set_submesh_visible((size_t) index, item->checkState() == Qt::CheckState::Checked);
+
+  _vtk_widget->update();
+  _vtk_widget->renderWindow()->Render();
+
+}
+
 void MainWindow::slot_btn_mfm_clicked() {
 
   std::cout << "slot_btn_mfm_clicked()" << std::endl;
@@ -401,6 +418,183 @@ MainWindow::is_int(const QString &str) const {
 
 }
 
+void
+MainWindow::start_load(const QString &file_path) {
+
+  QSettings settings;
+
+  // Load tecplot file in to a new model, zones after the first are decoded
+  // on demand. A binary cache of the model is written next to the file (or
+  // in the configured cache directory) once it is loaded, so that re-opening
+  // it skips parsing.
+  QString cache_dir = settings.value(CONFIG_MODEL_CACHE_DIR, "").toString();
+
+  ModelCache model_cache{
+      cache_dir.isEmpty()
+      ? std::nullopt
+      : std::optional<std::filesystem::path>{cache_dir.toStdString()}
+  };
+
+  QString suffix = QFileInfo{file_path}.suffix();
+  bool is_hdf5 = suffix == "h5";
+  bool is_binary_tecplot = suffix == "plt" || suffix == "szplt";
+
+  _btn_load_tecplot->setEnabled(false);
+  _load_progress_bar->setRange(0, 0);
+  _load_progress_bar->setVisible(true);
+  _btn_cancel_load->setEnabled(true);
+  _btn_cancel_load->setVisible(true);
+  _status_bar->showMessage(tr("Loading: ") + file_path);
+
+  // Join the previous load before starting a new one, this stops it if it is
+  // still writing a model cache.
+  _load_thread.reset();
+
+  _load_thread.emplace([this, file_path, is_hdf5, is_binary_tecplot, model_cache](std::stop_token stop_token) {
+
+    // Progress is reported from the worker threads, the GUI is only ever
+    // touched from its own thread.
+    LoadProgress progress{
+        [this](const std::string &stage, size_t done, size_t total) {
+          int percent = total == 0 ? -1 : (int) (100 * std::min(done, total) / total);
+          QMetaObject::invokeMethod(this, [this, stage = QString::fromStdString(stage), percent]() {
+            update_load_progress(stage, percent);
+          }, Qt::QueuedConnection);
+        },
+        stop_token
+    };
+
+    try {
+
+      std::string file_name = file_path.toStdString();
+
+      std::shared_ptr<Model> model;
+      if (is_hdf5) {
+        // Native HDF5 models load without any parsing.
+        model = std::make_shared<Model>(ModelHdf5::read(file_name));
+      } else if (is_binary_tecplot) {
+        // Binary tecplot is read without parsing, so it is not cached.
+        model = std::make_shared<Model>(
+            TecplotBinaryFileLoader::read(file_name, 0, &progress)
+        );
+      } else {
+        model = std::make_shared<Model>(
+            model_cache.load_or_read(file_name, FieldList::default_max_resident, &progress)
+        );
+      }
+
+      model->prepare_graphics(&progress);
+
+      QMetaObject::invokeMethod(this, [this, model, file_path]() {
+        finish_load(model, file_path);
+      }, Qt::QueuedConnection);
+
+      if (!is_hdf5 && !is_binary_tecplot) {
+        // The model is already on screen, so the cache is written after the
+        // fact. Starting another load stops this.
+        LoadProgress cache_progress{nullptr, stop_token};
+        try {
+          if (!model_cache.update(file_name, &cache_progress)) {
+            std::cout << "Could not write model cache for '" << file_name << "'." << std::endl;
+          }
+        } catch (const LoadCancelledException &) {
+        } catch (const std::exception &e) {
+          std::cout << "Could not write model cache for '" << file_name << "': " << e.what() << std::endl;
+        }
+      }
+
+    } catch (const LoadCancelledException &) {
+
+      QMetaObject::invokeMethod(this, [this]() {
+        end_load();
+        _status_bar->showMessage(tr("Loading cancelled."));
+      }, Qt::QueuedConnection);
+
+    } catch (const std::exception &e) {
+
+      QMetaObject::invokeMethod(this, [this, message = QString::fromStdString(e.what())]() {
+        fail_load(message);
+      }, Qt::QueuedConnection);
+
+    }
+
+  });
+
+}
+
+void
+MainWindow::cancel_load() {
+
+  if (_load_thread.has_value()) {
+    _load_thread->request_stop();
+    _btn_cancel_load->setEnabled(false);
+    _status_bar->showMessage(tr("Cancelling..."));
+  }
+
+}
+
+void
+MainWindow::update_load_progress(const QString &stage, int percent) {
+
+  if (percent < 0) {
+    // Unknown total, show a busy indicator.
+    _load_progress_bar->setRange(0, 0);
+  } else {
+    _load_progress_bar->setRange(0, 100);
+    _load_progress_bar->setValue(percent);
+  }
+  _load_progress_bar->setFormat(stage + ": %p%");
+
+}
+
+void
+MainWindow::finish_load(const std::shared_ptr<Model> &model, const QString &file_path) {
+
+  end_load();
+
+  // Replace the current model.
+  clear_model();
+
+  _model = std::move(*model);
+
+  _model->enable_graphics();
+  _model->set_arrow_scale(_txt_arrow_scale->text().toDouble());
+
+  show_arrow_actor();
+  show_ugrid_actor();
+
+  _chk_ugrid->setCheckState(Qt::CheckState::Checked);
+  _chk_vectors->setCheckState(Qt::CheckState::Checked);
+
+  populate_plane_parameters();
+  populate_submeshes();
+
+  _status_bar->showMessage(tr("Current file: ") + file_path);
+
+  _vtk_widget->update();
+  _vtk_widget->renderWindow()->Render();
+
+}
+
+void
+MainWindow::fail_load(const QString &message) {
+
+  end_load();
+
+  _status_bar->showMessage(tr("Loading failed."));
+  QMessageBox::critical(this, tr("Error"), tr("Could not load model: ") + message);
+
+}
+
+void
+MainWindow::end_load() {
+
+  _load_progress_bar->setVisible(false);
+  _btn_cancel_load->setVisible(false);
+  _btn_load_tecplot->setEnabled(true);
+
+}
+
 void
 MainWindow::clear_model() {
 
@@ -410,6 +604,32 @@ MainWindow::clear_model() {
   _chk_ugrid->setCheckState(Qt::CheckState::Unchecked);
   _chk_vectors->setCheckState(Qt::CheckState::Unchecked);
 
+  _lst_submeshes->clear();
+
+}
+
+void
+MainWindow::populate_submeshes() {
+
+  // One checkable entry per sub-mesh, the item data is the sub-mesh number.
+  QSignalBlocker blocker{_lst_submeshes};
+
+  _lst_submeshes->clear();
+
+  if (!_model.has_value()) return;
+
+  const auto &submeshes = _model->mesh().submeshes();
+  for (size_t index = 0; index < submeshes.size(); ++index) {
+    auto view = submeshes[index];
+    auto *item = new QListWidgetItem(
+        tr("sub-mesh %1 (%2 tetrahedra)").arg(view.id).arg(view.tets.size()),
+        _lst_submeshes
+    );
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    item->setCheckState(_model->submesh_visible(index) ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+    item->setData(Qt::UserRole, QVariant::fromValue((qulonglong) index));
+  }
+
 }
 
 void
@@ -5,12 +5,19 @@
 #ifndef MMPPT_TOY_QT_VTK_EX005_MAIN_WINDOW_HPP_
 #define MMPPT_TOY_QT_VTK_EX005_MAIN_WINDOW_HPP_
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <thread>
 
 #include <QErrorMessage>
 #include <QFileDialog>
+#include <QListWidget>
 #include <QMainWindow>
 #include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 #include <QSettings>
@@ -35,8 +42,12 @@
 #include "ui_main_window.h"
 
 #include "config_consts.h"
+#include "load_progress.hpp"
 #include "load_tecplot.hpp"
+#include "load_tecplot_binary.hpp"
 #include "model.hpp"
+#include "model_cache.hpp"
+#include "model_hdf5.hpp"
 #include "preferences_dialog.hpp"
 
 namespace {
@@ -105,7 +116,7 @@ class MainWindow : public QMainWindow, private Ui::MainWindow {
   //using PtrTrackballInteractor = vtkSmartPointer<TrackballInteractor>;
 
   MainWindow();
-  ~MainWindow() override = default;
+  ~MainWindow() override;
 
  public slots:
 
@@ -124,6 +135,7 @@ class MainWindow : public QMainWindow, private Ui::MainWindow {
   void slot_chk_vectors_changed(Qt::CheckState state);
   void slot_sli_ugrid_opacity_changed(int value);
   void slot_sli_vector_opacity_changed(int value);
+  void slot_lst_submeshes_item_changed(QListWidgetItem *item);
 
   void slot_btn_mfm_clicked();
   void slot_btn_holography_clicked();
@@ -169,6 +181,12 @@ class MainWindow : public QMainWindow, private Ui::MainWindow {
   bool _model_arrow_actor_showing{false};
   std::optional<Model> _model;
 
+  // Model loading happens on this thread so that the GUI stays responsive,
+  // the current model is kept until the new one is ready.
+  std::optional<std::jthread> _load_thread;
+  QProgressBar *_load_progress_bar;
+  QPushButton *_btn_cancel_load;
+
   //--------------------------------------------------------------------------
 
   [[nodiscard]] bool
@@ -180,6 +198,27 @@ class MainWindow : public QMainWindow, private Ui::MainWindow {
   void
   clear_model();
 
+  void
+  start_load(const QString &file_path);
+
+  void
+  cancel_load();
+
+  void
+  update_load_progress(const QString &stage, int percent);
+
+  void
+  finish_load(const std::shared_ptr<Model> &model, const QString &file_path);
+
+  void
+  fail_load(const QString &message);
+
+  void
+  end_load();
+
+  void
+  populate_submeshes();
+
   void
   hide_ugrid_actor();
 
@@ -0,0 +1,136 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_MAPPED_FILE_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A read-only memory mapping of a whole file. The mapping is shared, so the
+ * page cache is shared between all processes that map the same file. Files
+ * that can not be mapped (pipes, character devices, empty files or platforms
+ * without mmap) leave the object unmapped, callers should check
+ * `is_mapped()` and fall back to stream based reading.
+ */
+class MappedFile {
+
+ public:
+
+  /**
+   * Create a new mapping of the given file.
+   * @param file_name the name of the file to map.
+   * @param sequential hint to the kernel that the file is read front to back.
+   */
+  explicit MappedFile(const std::string &file_name, bool sequential = true) {
+
+#ifndef _WIN32
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+      ::close(fd);
+      return;
+    }
+
+    void *addr = ::mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+
+    if (addr == MAP_FAILED) return;
+
+    if (sequential) {
+      ::madvise(addr, (size_t) st.st_size, MADV_SEQUENTIAL);
+    }
+
+    _data = static_cast<const char *>(addr);
+    _size = (size_t) st.st_size;
+#else
+    (void) file_name;
+    (void) sequential;
+#endif
+
+  }
+
+  MappedFile(const MappedFile &) = delete;
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept :
+      _data{std::exchange(other._data, nullptr)},
+      _size{std::exchange(other._size, 0)} {}
+
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      unmap();
+      _data = std::exchange(other._data, nullptr);
+      _size = std::exchange(other._size, 0);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { unmap(); }
+
+  /**
+   * Check whether the file was successfully mapped.
+   * @return true if the file is mapped, otherwise false.
+   */
+  [[nodiscard]] bool
+  is_mapped() const { return _data != nullptr; }
+
+  /**
+   * Retrieve the mapped bytes.
+   * @return a pointer to the first byte of the file.
+   */
+  [[nodiscard]] const char *
+  data() const { return _data; }
+
+  /**
+   * Retrieve the size of the mapping.
+   * @return the size of the file in bytes.
+   */
+  [[nodiscard]] size_t
+  size() const { return _size; }
+
+  /**
+   * Retrieve the mapped bytes as a view.
+   * @return a view over the whole file.
+   */
+  [[nodiscard]] std::string_view
+  view() const { return {_data, _size}; }
+
+ private:
+
+  // Start of the mapping.
+  const char *_data{nullptr};
+
+  // Length of the mapping.
+  size_t _size{0};
+
+  void
+  unmap() {
+#ifndef _WIN32
+    if (_data != nullptr) {
+      ::munmap(const_cast<char *>(_data), _size);
+    }
+#endif
+    _data = nullptr;
+    _size = 0;
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_MAPPED_FILE_HPP_
@@ -9,16 +9,166 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <limits>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <sstream>
 #include <utility>
 #include <vector>
 #include <stdexcept>
 #include <unordered_map>
+#include <variant>
 
 #include "aliases.hpp"
+#include "curl.hpp"
+#include "point_locator.hpp"
+#include "reorder.hpp"
+#include "submeshes.hpp"
+#include "topology.hpp"
+
+//###########################################################################//
+//# Connectivity.                                                           #//
+//###########################################################################//
+
+/**
+ * The tetrahedra of a mesh. Vertex indices are stored with 32 bits when the
+ * number of vertices allows it, which halves the memory used by the
+ * connectivity, and with 64 bits otherwise.
+ */
+class Connectivity {
+
+ public:
+
+  /**
+   * Check whether the vertices of a mesh can be indexed with 32 bits.
+   * @param n_verts the number of vertices.
+   * @return true if 32 bit indices suffice, otherwise false.
+   */
+  [[nodiscard]] static constexpr bool
+  fits_32bit(size_t n_verts) {
+    return n_verts <= (size_t) std::numeric_limits<uint32_t>::max() + 1;
+  }
+
+  /**
+   * Create empty connectivity.
+   */
+  Connectivity() = default;
+
+  /**
+   * Create connectivity with 64 bit indices.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   */
+  Connectivity(tet_list til) :
+      _til{std::move(til)} {}
+
+  /**
+   * Create connectivity with 32 bit indices.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   */
+  Connectivity(tet32_list til) :
+      _til{std::move(til)} {}
+
+  /**
+   * Create connectivity with the narrowest indices that can address the
+   * vertices, the indices are zero.
+   * @param n_verts the number of vertices.
+   * @param n_tets the number of tetrahedra.
+   * @return the connectivity.
+   */
+  [[nodiscard]] static Connectivity
+  for_vertices(size_t n_verts, size_t n_tets) {
+    if (fits_32bit(n_verts)) return tet32_list(n_tets);
+    return tet_list(n_tets);
+  }
+
+  /**
+   * Retrieve the number of tetrahedra.
+   * @return the number of tetrahedra.
+   */
+  [[nodiscard]] size_t
+  size() const {
+    return std::visit([](const auto &til) { return til.size(); }, _til);
+  }
+
+  /**
+   * Retrieve the size of a vertex index.
+   * @return the size of a vertex index, 4 or 8 bytes.
+   */
+  [[nodiscard]] size_t
+  index_size() const {
+    return std::holds_alternative<tet32_list>(_til) ? sizeof(uint32_t) : sizeof(size_t);
+  }
+
+  /**
+   * Retrieve a tetrahedron.
+   * @param index the index of the tetrahedron.
+   * @return the tetrahedron's vertex indices.
+   */
+  [[nodiscard]] tet
+  operator[](size_t index) const {
+    if (const auto *til = std::get_if<tet32_list>(&_til)) {
+      const auto &t = (*til)[index];
+      return {t[0], t[1], t[2], t[3]};
+    }
+    return std::get<tet_list>(_til)[index];
+  }
+
+  /**
+   * Set one vertex index of a tetrahedron.
+   * @param index the index of the tetrahedron.
+   * @param corner the corner (0 to 3).
+   * @param vertex the vertex index, this must fit the index size.
+   */
+  void
+  set(size_t index, size_t corner, size_t vertex) {
+    if (auto *til = std::get_if<tet32_list>(&_til)) {
+      (*til)[index][corner] = (uint32_t) vertex;
+    } else {
+      std::get<tet_list>(_til)[index][corner] = vertex;
+    }
+  }
+
+  /**
+   * Call `fn` with the underlying tetrahedron list, a tet32_list or a
+   * tet_list.
+   * @param fn the function.
+   * @return the result of the function.
+   */
+  template<typename Fn>
+  decltype(auto)
+  visit(Fn &&fn) const { return std::visit(std::forward<Fn>(fn), _til); }
+
+  /**
+   * Retrieve the raw index storage, four indices of index_size() bytes for
+   * each tetrahedron.
+   * @return the start of the storage.
+   */
+  [[nodiscard]] const void *
+  data() const {
+    return std::visit([](const auto &til) -> const void * { return til.data(); }, _til);
+  }
+
+  /**
+   * Retrieve the raw index storage, four indices of index_size() bytes for
+   * each tetrahedron.
+   * @return the start of the storage.
+   */
+  void *
+  data() {
+    return std::visit([](auto &til) -> void * { return til.data(); }, _til);
+  }
+
+ private:
+
+  std::variant<tet32_list, tet_list> _til;
+
+};
 
 //###########################################################################//
 //# Mesh.                                                                   #//
@@ -37,12 +187,32 @@ class Mesh {
    * @param til the (t)etrahedra (i)ndex (l)ist.
    * @param sml the (s)ub-(m)esh list.
    */
-  Mesh(v_list vcl, tet_list til, sm_list sml) :
+  Mesh(v_list vcl, Connectivity til, sm_list sml) :
       _vcl(std::move(vcl)),
       _til(std::move(til)),
       _sml(std::move(sml))
       {}
 
+  /**
+   * Constructor will create a new mesh that has been renumbered.
+   * @param vcl the (v)ertex (c)oordinate (l)ist.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   * @param sml the (s)ub-(m)esh list.
+   * @param order the original index of each vertex and tetrahedron.
+   */
+  Mesh(v_list vcl, Connectivity til, sm_list sml, MeshOrder order) :
+      _vcl(std::move(vcl)),
+      _til(std::move(til)),
+      _sml(std::move(sml)),
+      _order(std::move(order)) {
+
+    if ((!_order.vertex_order.empty() && _order.vertex_order.size() != _vcl.size())
+        || (!_order.tet_order.empty() && _order.tet_order.size() != _til.size())) {
+      throw std::invalid_argument("The mesh order does not match the mesh.");
+    }
+
+  }
+
   /**
    * Retrieve the vertex coordinate list.
    * @return the vertex coordinate list.
@@ -58,7 +228,7 @@ class Mesh {
    * Retrieve the tetrahedra index list.
    * @return the tetrahedra index list.
    */
-  [[nodiscard]] const tet_list &
+  [[nodiscard]] const Connectivity &
   til() const {
 
     return _til;
@@ -76,17 +246,255 @@ class Mesh {
 
   }
 
+  /**
+   * Retrieve the original index of each vertex, for writing results in the
+   * numbering of the file that the mesh came from.
+   * @return the original vertex indices, empty if the vertices have not
+   *         been renumbered.
+   */
+  [[nodiscard]] const vi_list &
+  vertex_order() const {
+
+    return _order.vertex_order;
+
+  }
+
+  /**
+   * Retrieve the original index of each tetrahedron.
+   * @return the original tetrahedron indices, empty if the tetrahedra have
+   *         not been renumbered.
+   */
+  [[nodiscard]] const teti_list &
+  tet_order() const {
+
+    return _order.tet_order;
+
+  }
+
+  /**
+   * Check whether the mesh has been renumbered.
+   * @return true if the mesh has been renumbered, otherwise false.
+   */
+  [[nodiscard]] bool
+  is_reordered() const {
+
+    return !_order.vertex_order.empty() || !_order.tet_order.empty();
+
+  }
+
+  /**
+   * Compute a renumbering of the mesh that improves the locality of its
+   * vertices and tetrahedra.
+   * @param ordering the ordering.
+   * @return the new order, relative to the current numbering.
+   */
+  [[nodiscard]] MeshOrder
+  order(Ordering ordering) const {
+
+    return _til.visit([&](const auto &til) { return mesh_order(_vcl, til, ordering); });
+
+  }
+
+  /**
+   * Create a renumbered copy of the mesh. The original indices of the copy
+   * are composed with those of this mesh, so they still refer to the file
+   * that the mesh came from.
+   * @param order the new order, relative to the current numbering.
+   * @return the renumbered mesh.
+   */
+  [[nodiscard]] Mesh
+  permuted(const MeshOrder &order) const {
+
+    if (order.vertex_order.size() != _vcl.size() || order.tet_order.size() != _til.size()) {
+      throw std::invalid_argument("The mesh order does not match the mesh.");
+    }
+
+    vi_list new_index(_vcl.size());
+    for (size_t i = 0; i < new_index.size(); ++i) new_index[order.vertex_order[i]] = i;
+
+    v_list vcl(_vcl.size());
+    for (size_t i = 0; i < vcl.size(); ++i) vcl[i] = _vcl[order.vertex_order[i]];
+
+    Connectivity til = _til.visit([&]<typename Index>(const basic_tet_list<Index> &old_til) {
+      basic_tet_list<Index> new_til(old_til.size());
+      for (size_t t = 0; t < new_til.size(); ++t) {
+        const auto &old_tet = old_til[order.tet_order[t]];
+        for (size_t k = 0; k < 4; ++k) new_til[t][k] = (Index) new_index[old_tet[k]];
+      }
+      return Connectivity{std::move(new_til)};
+    });
+
+    sm_list sml(_sml.size());
+    for (size_t t = 0; t < sml.size(); ++t) sml[t] = _sml[order.tet_order[t]];
+
+    MeshOrder original = order;
+    if (!_order.vertex_order.empty()) {
+      for (auto &i : original.vertex_order) i = _order.vertex_order[i];
+    }
+    if (!_order.tet_order.empty()) {
+      for (auto &t : original.tet_order) t = _order.tet_order[t];
+    }
+
+    return {std::move(vcl), std::move(til), std::move(sml), std::move(original)};
+
+  }
+
+  /**
+   * Retrieve the faces, edges and neighbours of the mesh. The topology is
+   * built by the first call, which may come from any thread.
+   * @return the topology.
+   */
+  [[nodiscard]] const Topology &
+  topology() const {
+
+    std::call_once(_topology->built, [this]() {
+      _topology->value = _til.visit([this](const auto &til) { return Topology{til, _vcl.size()}; });
+    });
+
+    return _topology->value;
+
+  }
+
+  /**
+   * Retrieve the tetrahedra of the mesh partitioned by sub-mesh. The
+   * partition is built by the first call, which may come from any thread.
+   * @return the sub-meshes.
+   */
+  [[nodiscard]] const SubMeshes &
+  submeshes() const {
+
+    std::call_once(_submeshes->built, [this]() { _submeshes->value = SubMeshes{_sml}; });
+
+    return _submeshes->value;
+
+  }
+
+  /**
+   * Retrieve the curl operator of the mesh. The operator is built by the
+   * first call, which may come from any thread.
+   * @return the curl operator.
+   */
+  [[nodiscard]] const CurlOperator &
+  curl_operator() const {
+
+    std::call_once(_curl_operator->built, [this]() {
+      _curl_operator->value = _til.visit([this](const auto &til) { return CurlOperator{_vcl, til}; });
+    });
+
+    return _curl_operator->value;
+
+  }
+
+  /**
+   * Compute the curl of a field at every vertex.
+   * @param field the field.
+   * @param curl the curl at each vertex.
+   * @param scratch storage reused between calls, one per thread.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  void
+  curl(const Field &field, fv_list &curl, CurlOperator::Scratch &scratch, size_t n_threads = 0) const {
+
+    curl_operator().apply(field, curl, scratch, n_threads);
+
+  }
+
+  /**
+   * Compute the curl of many fields at every vertex, several fields at a
+   * time (see CurlOperator::batch_size).
+   * @param fields the fields.
+   * @param curls the curl of each field at each vertex.
+   * @param scratch storage reused between calls, one per thread.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  void
+  curl(std::span<const Field *const> fields, std::span<fv_list> curls, CurlOperator::Scratch &scratch,
+       size_t n_threads = 0) const {
+
+    curl_operator().apply(fields, curls, scratch, n_threads);
+
+  }
+
+  /**
+   * Retrieve the point locator of the mesh. The locator is built by the
+   * first call, which may come from any thread.
+   * @return the point locator.
+   */
+  [[nodiscard]] const PointLocator &
+  locator() const {
+
+    std::call_once(_locator->built, [this]() {
+      _locator->value = _til.visit([this](const auto &til) { return PointLocator{_vcl, til}; });
+    });
+
+    return _locator->value;
+
+  }
+
+  /**
+   * Find the tetrahedron that contains a point.
+   * @param point the point.
+   * @return the tetrahedron and the point's barycentric coordinates, or
+   *         nothing if the point is outside the mesh.
+   */
+  [[nodiscard]] std::optional<PointLocator::Location>
+  locate(const vert &point) const {
+
+    const PointLocator &point_locator = locator();
+    return _til.visit([&](const auto &til) { return point_locator.locate(_vcl, til, point); });
+
+  }
+
+  /**
+   * Find the tetrahedra that contain many points, in parallel.
+   * @param points the points.
+   * @param locations the locations of the points, tet is
+   *                  PointLocator::no_tet for points outside the mesh. This
+   *                  must be as long as `points`.
+   */
+  void
+  locate(std::span<const vert> points, std::span<PointLocator::Location> locations) const {
+
+    const PointLocator &point_locator = locator();
+    _til.visit([&](const auto &til) { point_locator.locate(_vcl, til, points, locations); });
+
+  }
+
  private:
 
+  // Something that is built on first use. It is shared by copies of the
+  // mesh, which have the same vertices and tetrahedra.
+  template<typename T>
+  struct Lazy {
+    std::once_flag built;
+    T value;
+  };
+
   // Vertex list.
   v_list _vcl;
 
   // Tetrahedra (index) list.
-  tet_list _til;
+  Connectivity _til;
 
   // Sub-mesh (index) list.
   sm_list _sml;
 
+  // The original index of each vertex and tetrahedron, empty if the mesh
+  // has not been renumbered.
+  MeshOrder _order;
+
+  // Topology.
+  std::shared_ptr<Lazy<Topology>> _topology{std::make_shared<Lazy<Topology>>()};
+
+  // Tetrahedra partitioned by sub-mesh.
+  std::shared_ptr<Lazy<SubMeshes>> _submeshes{std::make_shared<Lazy<SubMeshes>>()};
+
+  // Curl operator.
+  std::shared_ptr<Lazy<CurlOperator>> _curl_operator{std::make_shared<Lazy<CurlOperator>>()};
+
+  // Point locator.
+  std::shared_ptr<Lazy<PointLocator>> _locator{std::make_shared<Lazy<PointLocator>>()};
+
 };
 
 #endif // MMPPT_TOY_QT_VTK_EX005_MESH_HPP_
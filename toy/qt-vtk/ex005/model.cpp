@@ -23,13 +23,44 @@ Model::add_field(Field field) {
   _field_list.add_field(std::move(field));
 }
 
-void Model::enable_graphics() {
+void
+Model::set_field_encoding(FieldList::Encoding encoding) {
+  _field_list.set_encoding(encoding);
+}
+
+void
+Model::reorder(Ordering ordering) {
+
+  if (_graphics_prepared) {
+    throw std::logic_error("A model can not be reordered after its graphics have been prepared.");
+  }
+
+  MeshOrder order = _mesh.order(ordering);
+
+  _field_list = _field_list.permuted(std::make_shared<const vi_list>(order.vertex_order));
+  _mesh = _mesh.permuted(order);
+
+}
+
+void Model::prepare_graphics(LoadProgress *progress) {
   setup_ugrid();
-  setup_ugrid_fields();
-  setup_arrows();
+  setup_ugrid_fields(progress);
+  setup_surface();
+
+  _graphics_prepared = true;
+}
 
-  _ugrid->GetPointData()->SetActiveVectors(_mag_names[0].c_str());
-  _ugrid->GetPointData()->SetActiveScalars(_rheli_names[0].c_str());
+bool Model::graphics_prepared() const {
+  return _graphics_prepared;
+}
+
+void Model::enable_graphics() {
+  if (!_graphics_prepared) {
+    prepare_graphics();
+  }
+
+  setup_ugrid_actor();
+  setup_arrows();
 
   _graphics_enabled = true;
 }
@@ -53,6 +84,89 @@ Model::ugrid() const {
   return _ugrid;
 }
 
+vtkSmartPointer<vtkPolyDataMapper>
+Model::surface_mapper() const {
+  return _surface_mapper;
+}
+
+vtkSmartPointer<vtkPolyData>
+Model::surface() const {
+  return _surface;
+}
+
+void
+Model::set_ugrid_surface_only(bool surface_only) {
+  _ugrid_surface_only = surface_only;
+  if (_ugrid_actor) {
+    if (surface_only) {
+      _ugrid_actor->SetMapper(_surface_mapper);
+    } else {
+      _ugrid_actor->SetMapper(_ugrid_ds_mapper);
+    }
+  }
+}
+
+bool
+Model::ugrid_surface_only() const {
+  return _ugrid_surface_only;
+}
+
+void
+Model::set_submesh_visible(size_t index, bool visible) {
+
+  if (!_graphics_prepared) {
+    throw std::logic_error("Sub-meshes can only be shown or hidden once the graphics have been prepared.");
+  }
+
+  if (_submesh_visible.at(index) == visible) return;
+  _submesh_visible[index] = visible;
+
+  const auto &til = _mesh.til();
+
+  // Everything is shown until the first sub-mesh is hidden.
+  if (!_cell_ghosts) {
+    _cell_ghosts = _ugrid->AllocateCellGhostArray();
+    _point_ghosts = _ugrid->AllocatePointGhostArray();
+    _vertex_visible_tets.assign(_mesh.vcl().size(), 0);
+    for (size_t t = 0; t < til.size(); ++t) {
+      for (size_t v : til[t]) ++_vertex_visible_tets[v];
+    }
+  }
+
+  unsigned char *cell_ghosts = _cell_ghosts->GetPointer(0);
+  unsigned char *point_ghosts = _point_ghosts->GetPointer(0);
+
+  for (size_t t : _mesh.submeshes()[index].tets) {
+
+    if (visible) {
+      cell_ghosts[t] &= (unsigned char) ~vtkDataSetAttributes::HIDDENCELL;
+    } else {
+      cell_ghosts[t] |= (unsigned char) vtkDataSetAttributes::HIDDENCELL;
+    }
+
+    for (size_t v : til[t]) {
+      if (visible) {
+        if (_vertex_visible_tets[v]++ == 0) point_ghosts[v] &= (unsigned char) ~vtkDataSetAttributes::HIDDENPOINT;
+      } else {
+        if (--_vertex_visible_tets[v] == 0) point_ghosts[v] |= (unsigned char) vtkDataSetAttributes::HIDDENPOINT;
+      }
+    }
+
+  }
+
+  _cell_ghosts->Modified();
+  _point_ghosts->Modified();
+  _ugrid->Modified();
+
+  update_surface();
+
+}
+
+bool
+Model::submesh_visible(size_t index) const {
+  return _submesh_visible.at(index);
+}
+
 std::string
 Model::field_name(const std::string &prefix, int index) const {
   std::stringstream ss_mag;
@@ -69,14 +183,206 @@ Model::field_name_index(const std::string &name) const {
   return std::nullopt;
 }
 
-std::unordered_map<std::string, Model::MinMax>
-Model::heli_minmax() const {
-  return _heli_minmax;
+vtkSmartPointer<vtkDataArray>
+Model::zone_array(int index, Quantity quantity) {
+
+  check_zone(index);
+
+  size_t key = array_key(index, quantity);
+
+  auto it = _arrays.find(key);
+  if (it != _arrays.end()) {
+    _array_lru.splice(_array_lru.begin(), _array_lru, it->second.lru);
+    return it->second.array;
+  }
+
+  auto field = _field_list.field(index);
+
+  if (quantity == Quantity::Magnetisation) {
+
+    auto array = ugrid_field_array(field);
+    array->SetName(array_name(index, quantity).c_str());
+    cache_array(key, array, std::move(field));
+
+  } else {
+
+    // The vorticity is cached with the helicity pair, so the curl of a zone
+    // is only computed again once its vorticity has been evicted.
+    auto cached = _arrays.find(array_key(index, Quantity::Vorticity));
+
+    if (cached != _arrays.end()) {
+
+      auto *vorticity = FieldArray::SafeDownCast(cached->second.array);
+      std::span<const fv> vectors{reinterpret_cast<const fv *>(vorticity->GetPointer(0)),
+                                  (size_t) vorticity->GetNumberOfTuples()};
+      cache_zone_arrays(index, setup_ugrid_calculations(index, *field, vectors, false, 0), quantity);
+
+    } else {
+
+      _mesh.curl(*field, _curl, _curl_scratch);
+      cache_zone_arrays(index, setup_ugrid_calculations(index, *field, _curl, true, 0), quantity);
+
+    }
+
+  }
+
+  evict_arrays(key);
+  update_surface_point_data();
+
+  return _arrays.at(key).array;
+
+}
+
+void
+Model::prefetch_zones(int first, int count, LoadProgress *progress) {
+
+  if (count <= 0) return;
+
+  check_zone(first);
+  check_zone(first + count - 1);
+
+  // Zones whose helicity and relative helicity are both cached are skipped.
+  std::vector<int> indices;
+  for (int i = first; i < first + count; ++i) {
+    if (!_arrays.contains(array_key(i, Quantity::Helicity))
+        || !_arrays.contains(array_key(i, Quantity::RelativeHelicity))) {
+      indices.push_back(i);
+    }
+  }
+
+  if (progress) progress->start("Computing fields", indices.size());
+
+  // The curl operator is applied to a batch of zones at a time, which reads
+  // its entries once per batch rather than once per zone. Batches are
+  // independent, so several lanes compute them concurrently (and each batch
+  // is itself parallel). A lane has its own scratch and holds one batch at a
+  // time, whose arrays it adds to the cache as soon as they are computed,
+  // so the memory in flight is bounded by the number of lanes rather than
+  // by count. There are no more lanes than fit in the array budget.
+
+  constexpr size_t batch_size = CurlOperator::batch_size;
+
+  size_t n_batches = (indices.size() + batch_size - 1) / batch_size;
+  size_t lane_bytes = std::max<size_t>(
+      (3 * batch_size * sizeof(field_scalar) + batch_size * sizeof(fv)) * _mesh.vcl().size(), 1);
+  size_t n_lanes = std::min({n_batches, thread_count(), std::max<size_t>(_array_budget / lane_bytes, 1)});
+
+  // Build the operator first, so that it is not built by a worker thread.
+  (void) _mesh.curl_operator();
+
+  std::atomic<size_t> next_batch{0};
+  std::mutex cache_mutex;
+
+  parallel_for(n_lanes, [&](size_t) {
+
+    CurlOperator::Scratch scratch;
+    std::vector<FieldList::FieldPtr> batch;
+    std::vector<const Field *> batch_fields;
+    std::vector<fv_list> vorticities(batch_size);
+
+    for (size_t batch_index = next_batch++; batch_index < n_batches; batch_index = next_batch++) {
+
+      if (progress) progress->check_cancelled();
+
+      size_t begin = batch_index * batch_size;
+      size_t end = std::min(begin + batch_size, indices.size());
+
+      batch.clear();
+      batch_fields.clear();
+      for (size_t i = begin; i < end; ++i) {
+        batch.push_back(_field_list.field(indices[i]));
+        batch_fields.push_back(batch.back().get());
+      }
+
+      _mesh.curl(batch_fields, std::span<fv_list>{vorticities.data(), end - begin}, scratch);
+
+      for (size_t i = begin; i < end; ++i) {
+        ZoneArrays zone = setup_ugrid_calculations(indices[i], *batch[i - begin], vorticities[i - begin], false, 0);
+        batch[i - begin].reset();
+        {
+          std::lock_guard<std::mutex> lock{cache_mutex};
+          cache_zone_arrays(indices[i], std::move(zone), Quantity::RelativeHelicity);
+          evict_arrays();
+        }
+        if (progress) progress->advance(1);
+      }
+
+    }
+
+  }, n_lanes);
+
+  update_surface_point_data();
+
+}
+
+void
+Model::set_active_zone(int index) {
+
+  check_zone(index);
+
+  // The field is made active before the relative helicity is computed, so
+  // that it can not be evicted to make room for it.
+  auto vectors = zone_array(index, Quantity::Magnetisation);
+  _ugrid->GetPointData()->SetActiveVectors(vectors->GetName());
+
+  auto scalars = zone_array(index, Quantity::RelativeHelicity);
+  _ugrid->GetPointData()->SetActiveScalars(scalars->GetName());
+
+  _active_zone = index;
+
+  // The previous zone's arrays may be evicted now.
+  evict_arrays();
+  update_surface_point_data();
+
+}
+
+int
+Model::active_zone() const {
+  return _active_zone;
+}
+
+void
+Model::set_array_budget(size_t budget) {
+
+  _array_budget = budget;
+
+  if (_ugrid) {
+    evict_arrays();
+    update_surface_point_data();
+  }
+
+}
+
+size_t
+Model::array_budget() const {
+  return _array_budget;
 }
 
-std::unordered_map<std::string, Model::MinMax>
-Model::rheli_minmax() const {
-  return _rheli_minmax;
+void
+Model::set_prefetch_count(size_t count) {
+  _prefetch_count = count;
+}
+
+size_t
+Model::prefetch_count() const {
+  return _prefetch_count;
+}
+
+size_t
+Model::resident_array_bytes() const {
+  return _array_bytes;
+}
+
+Model::MinMax
+Model::heli_minmax(int index) {
+  if (!_heli_minmax.contains(index)) zone_array(index, Quantity::Helicity);
+  return _heli_minmax.at(index);
+}
+
+Model::MinMax
+Model::rheli_minmax(int index) {
+  if (!_rheli_minmax.contains(index)) zone_array(index, Quantity::RelativeHelicity);
+  return _rheli_minmax.at(index);
 }
 
 double
@@ -156,38 +462,187 @@ Model::setup_ugrid() {
 
   // Create the unstructured grid.
 
-  _ugrid = vtkUnstructuredGrid::New();
+  _ugrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
 
-  // Add vertex points to the unstructured grid.
-  vtkSmartPointer<vtkPoints> points = vtkPoints::New();
-  points->SetNumberOfPoints((vtkIdType) _mesh.vcl().size());
+  // The points and connectivity wrap the mesh's storage rather than copying
+  // it. VTK only reads them, but its array API takes non-const pointers. The
+  // arrays are told not to free the memory, the mesh outlives the grid.
 
+  // Add vertex points to the unstructured grid, v_list is already laid out
+  // as x, y, z triples.
   const auto &vcl = _mesh.vcl();
-  for (vtkIdType i = 0; i < vcl.size(); ++i) {
-    points->SetPoint(i, vcl[i][0], vcl[i][1], vcl[i][2]);
-  }
+
+  auto coordinates = vtkSmartPointer<vtkDoubleArray>::New();
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetArray(const_cast<double *>(vcl.empty() ? nullptr : vcl.front().data()),
+                        (vtkIdType) (3 * vcl.size()), 1);
+
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  points->SetData(coordinates);
   _ugrid->SetPoints(points);
 
-  // Add connectivity information for unstructured grids.
+  // Add connectivity information for unstructured grids. The tetrahedra are
+  // runs of four vertex indices, which is exactly a vtkCellArray
+  // connectivity array, only the offsets are built. vtkCellArray accepts 32
+  // and 64 bit storage, so 32 bit meshes are wrapped as they are.
+  static_assert(sizeof(size_t) == sizeof(vtkTypeInt64), "Tetrahedron indices must be 64 bit.");
+
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+
+  _mesh.til().visit([&cells]<typename Index>(const basic_tet_list<Index> &til) {
+
+    using IndexArray = std::conditional_t<sizeof(Index) == sizeof(vtkTypeInt32),
+                                          vtkTypeInt32Array, vtkTypeInt64Array>;
+    using Value = typename IndexArray::ValueType;
+
+    auto connectivity = vtkSmartPointer<IndexArray>::New();
+    connectivity->SetArray(
+        reinterpret_cast<Value *>(const_cast<Index *>(til.empty() ? nullptr : til.front().data())),
+        (vtkIdType) (4 * til.size()), 1);
+
+    auto offsets = vtkSmartPointer<IndexArray>::New();
+    offsets->SetNumberOfValues((vtkIdType) til.size() + 1);
+    Value *offset = offsets->GetPointer(0);
+    for (size_t i = 0; i <= til.size(); ++i) {
+      offset[i] = (Value) (4 * i);
+    }
+
+    cells->SetData(offsets, connectivity);
+
+  });
+
+  _ugrid->SetCells(VTK_TETRA, cells);
+
+}
+
+void
+Model::setup_surface() {
+
+  // The surface is the faces that belong to one tetrahedron, or to two
+  // tetrahedra of different sub-meshes. Each triangle is wound so that its
+  // normal points away from the first tetrahedron of its face.
+
+  const auto &vcl = _mesh.vcl();
   const auto &til = _mesh.til();
-  for (vtkIdType i = 0; i < til.size(); ++i) {
-    vtkIdType element[4] = {
-        (vtkIdType) til[i][0],
-        (vtkIdType) til[i][1],
-        (vtkIdType) til[i][2],
-        (vtkIdType) til[i][3]
-    };
-    _ugrid->InsertNextCell(VTK_TETRA, 4, element);
+  const auto &submeshes = _mesh.submeshes();
+  const auto &sml = _mesh.sml();
+
+  _submesh_visible.assign(submeshes.size(), true);
+
+  _mesh.topology().visit([&]<typename Id>(const BasicTopology<Id> &topology) {
+
+    std::vector<Id> faces = topology.surface_faces(sml);
+
+    _surface_faces.resize(faces.size());
+
+    for (size_t i = 0; i < faces.size(); ++i) {
+
+      auto tets = topology.face_tets(faces[i]);
+      size_t t = tets[0];
+      size_t local = topology.local_face(t, faces[i]);
+      tet vertices = til[t];
+
+      const auto &corners = BasicTopology<Id>::local_faces[local];
+      size_t a = vertices[corners[0]], b = vertices[corners[1]], c = vertices[corners[2]];
+      const auto &p = vcl[a], &q = vcl[b], &r = vcl[c], &o = vcl[vertices[local]];
+
+      // (q - p) x (r - p) . (o - p) > 0 means the normal points towards the
+      // opposite vertex, i.e. inwards.
+      std::array<double, 3> u{q[0] - p[0], q[1] - p[1], q[2] - p[2]};
+      std::array<double, 3> v{r[0] - p[0], r[1] - p[1], r[2] - p[2]};
+      std::array<double, 3> w{o[0] - p[0], o[1] - p[1], o[2] - p[2]};
+      double inwards = (u[1] * v[2] - u[2] * v[1]) * w[0]
+          + (u[2] * v[0] - u[0] * v[2]) * w[1]
+          + (u[0] * v[1] - u[1] * v[0]) * w[2];
+      if (inwards > 0.0) std::swap(b, c);
+
+      _surface_faces[i] = {
+          {(vtkTypeInt64) a, (vtkTypeInt64) b, (vtkTypeInt64) c},
+          (uint32_t) *submeshes.index_of(sml[t]),
+          tets.size() == 2 ? (uint32_t) *submeshes.index_of(sml[tets[1]]) : no_submesh
+      };
+
+    }
+
+  });
+
+  _surface = vtkSmartPointer<vtkPolyData>::New();
+  _surface->SetPoints(_ugrid->GetPoints());
+
+  // The point data arrays are shared, not copied.
+  _surface->GetPointData()->ShallowCopy(_ugrid->GetPointData());
+
+  update_surface();
+
+}
+
+void
+Model::update_surface() {
+
+  auto visible = [this](uint32_t submesh) {
+    return submesh != no_submesh && _submesh_visible[submesh];
+  };
+
+  // A face is drawn if it separates a shown sub-mesh from a hidden one or
+  // from the outside, or if it is the interface between two different shown
+  // sub-meshes.
+  auto drawn = [&visible](const SurfaceFace &face) {
+    bool inner = visible(face.inner), outer = visible(face.outer);
+    return (inner || outer) && (inner != outer || face.inner != face.outer);
+  };
+
+  vtkIdType n_triangles = 0;
+  for (const auto &face : _surface_faces) {
+    if (drawn(face)) ++n_triangles;
   }
 
-  // Create the dataset mapper.
-  _ugrid_ds_mapper = vtkDataSetMapper::New();
+  auto connectivity = vtkSmartPointer<vtkTypeInt64Array>::New();
+  connectivity->SetNumberOfValues(3 * n_triangles);
+  vtkTypeInt64 *triangle = connectivity->GetPointer(0);
+
+  for (const auto &face : _surface_faces) {
+
+    if (!drawn(face)) continue;
+
+    // Faces whose inner side is hidden are seen from the other side.
+    bool inner = visible(face.inner);
+    *triangle++ = face.corners[0];
+    *triangle++ = face.corners[inner ? 1 : 2];
+    *triangle++ = face.corners[inner ? 2 : 1];
+
+  }
+
+  auto offsets = vtkSmartPointer<vtkTypeInt64Array>::New();
+  offsets->SetNumberOfValues(n_triangles + 1);
+  vtkTypeInt64 *offset = offsets->GetPointer(0);
+  for (vtkIdType i = 0; i <= n_triangles; ++i) {
+    offset[i] = (vtkTypeInt64) (3 * i);
+  }
+
+  auto polys = vtkSmartPointer<vtkCellArray>::New();
+  polys->SetData(offsets, connectivity);
+
+  _surface->SetPolys(polys);
+
+}
+
+void
+Model::setup_ugrid_actor() {
+
+  // Create the dataset mapper, used when the whole grid is rendered.
+  _ugrid_ds_mapper = vtkSmartPointer<vtkDataSetMapper>::New();
   _ugrid_ds_mapper->SetInputData(_ugrid);
   _ugrid_ds_mapper->ScalarVisibilityOff();
 
+  // Create the surface mapper, by default only the surface is rendered so
+  // that the cost of drawing depends on the surface rather than the volume.
+  _surface_mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  _surface_mapper->SetInputData(_surface);
+  _surface_mapper->ScalarVisibilityOff();
+
   // Create the actor.
-  _ugrid_actor = vtkActor::New();
-  _ugrid_actor->SetMapper(_ugrid_ds_mapper);
+  _ugrid_actor = vtkSmartPointer<vtkActor>::New();
+  set_ugrid_surface_only(_ugrid_surface_only);
 
   //_u_grid_actor->GetProperty()->SetRepresentationToWireframe();
   _ugrid_actor->GetProperty()->SetRepresentationToSurface();
@@ -200,145 +655,239 @@ Model::setup_ugrid() {
 }
 
 void
-Model::setup_ugrid_fields() {
+Model::setup_ugrid_fields(LoadProgress *progress) {
 
-  std::cout << "setup_ugrid_fields()" << std::endl;
+  // Only the first zones are computed, one batch of the curl operator
+  // costs about as much as a single zone. The arrays of other zones are
+  // computed when they are asked for (see zone_array()).
 
-  for (int i = 0; i < _field_list.n_fields(); ++i) {
-    const auto &f = _field_list.fields()[i];
-    setup_ugrid_field(i, f);
-    setup_ugrid_calculations(i);
+  if (_field_list.n_fields() == 0) {
+    if (progress) progress->start("Computing fields", 0);
+    return;
   }
 
+  prefetch_zones(0, (int) std::min<size_t>(_prefetch_count, _field_list.n_fields()), progress);
+  set_active_zone(0);
+
 }
 
-void
-Model::setup_ugrid_field(int index, const Field &field) {
+vtkSmartPointer<vtkDataArray>
+Model::ugrid_field_array(FieldList::FieldPtr &field) {
 
-  std::cout << "setup_ugrid_field()" << std::endl;
+  // VTK only reads field values, but its array API takes non-const
+  // pointers. The arrays are told not to free the memory.
+
+  if (field->is_quantised()) {
+
+    // Quantised vectors have to be decoded, the field does not need to be
+    // kept.
+    vtkSmartPointer<FieldArray> decoded = vtkSmartPointer<FieldArray>::New();
+    decoded->SetNumberOfComponents(3);
+    decoded->SetNumberOfTuples((vtkIdType) field->size());
+    field->quantised_vectors().decode(0, field->size(), decoded->GetPointer(0));
+    field.reset();
+    return decoded;
+
+  }
 
-  const auto &vectors = field.vectors();
+  if (field->is_view()) {
 
-  vtkSmartPointer<vtkDoubleArray> f = vtkDoubleArray::New();
-  f->SetName(field_name("m", index).c_str());
-  f->SetNumberOfComponents(3);
-  f->SetNumberOfTuples((vtkIdType) vectors.size());
+    // A view holds each component in its own row of the block.
+    auto soa = vtkSmartPointer<vtkSOADataArrayTemplate<field_scalar>>::New();
+    soa->SetNumberOfComponents(3);
+    for (int c = 0; c < 3; ++c) {
+      auto component = field->component(c);
+      soa->SetArray(c, const_cast<field_scalar *>(component.data()),
+                    (vtkIdType) component.size(), true, true);
+    }
+    return soa;
 
-  for (vtkIdType i = 0; i < vectors.size(); ++i) {
-    double fd[3] = {vectors[i][0], vectors[i][1], vectors[i][2]};
-    f->SetTuple(i, fd);
   }
 
-  _ugrid->GetPointData()->AddArray(f);
+  // Owned vectors are interleaved, which is the VTK array layout.
+  const auto &vectors = field->vectors();
+  vtkSmartPointer<FieldArray> aos = vtkSmartPointer<FieldArray>::New();
+  aos->SetNumberOfComponents(3);
+  aos->SetArray(const_cast<field_scalar *>(vectors.empty() ? nullptr : vectors.front().data()),
+                (vtkIdType) (3 * vectors.size()), 1);
+  return aos;
+
+}
+
+Model::ZoneArrays
+Model::setup_ugrid_calculations(int index, const Field &field, std::span<const fv> vorticity,
+                                bool keep_vorticity, size_t n_threads) const {
+
+  ZoneArrays zone;
+
+  // Helicity, dot(m, v), and relative helicity, dot(m, v) / mag(v), which is
+  // zero where the vorticity is.
+
+  auto n_verts = (vtkIdType) vorticity.size();
+
+  vtkSmartPointer<FieldArray> hug_darray = vtkSmartPointer<FieldArray>::New();
+  hug_darray->SetName(array_name(index, Quantity::Helicity).c_str());
+  hug_darray->SetNumberOfComponents(1);
+  hug_darray->SetNumberOfTuples(n_verts);
+  field_scalar *helicity = hug_darray->GetPointer(0);
+
+  vtkSmartPointer<FieldArray> rhug_darray = vtkSmartPointer<FieldArray>::New();
+  rhug_darray->SetName(array_name(index, Quantity::RelativeHelicity).c_str());
+  rhug_darray->SetNumberOfComponents(1);
+  rhug_darray->SetNumberOfTuples(n_verts);
+  field_scalar *relative_helicity = rhug_darray->GetPointer(0);
+
+  field_scalar *vort = nullptr;
+  if (keep_vorticity) {
+    zone.vorticity = vtkSmartPointer<FieldArray>::New();
+    zone.vorticity->SetName(array_name(index, Quantity::Vorticity).c_str());
+    zone.vorticity->SetNumberOfComponents(3);
+    zone.vorticity->SetNumberOfTuples(n_verts);
+    vort = zone.vorticity->GetPointer(0);
+  }
+
+  parallel_for_blocks(vorticity.size(), 1 << 14, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      fv m = field.vector(i);
+      const fv &v = vorticity[i];
+      double h = (double) m[0] * v[0] + (double) m[1] * v[1] + (double) m[2] * v[2];
+      double v_mag = std::sqrt((double) v[0] * v[0] + (double) v[1] * v[1] + (double) v[2] * v[2]);
+      helicity[i] = (field_scalar) h;
+      relative_helicity[i] = (field_scalar) (v_mag > 0.0 ? h / v_mag : 0.0);
+      if (vort) std::copy(v.begin(), v.end(), vort + 3 * i);
+    }
+  }, n_threads);
+
+  double hrange[2];
+  hug_darray->GetRange(hrange);
+  zone.helicity = hug_darray;
+  zone.heli_minmax = {.min = hrange[0], .max = hrange[1]};
+
+  double rhrange[2];
+  rhug_darray->GetRange(rhrange);
+  zone.relative_helicity = rhug_darray;
+  zone.rheli_minmax = {.min = rhrange[0], .max = rhrange[1]};
+
+  return zone;
+
+}
+
+void
+Model::cache_zone_arrays(int index, ZoneArrays zone, Quantity requested) {
+
+  _heli_minmax[index] = zone.heli_minmax;
+  _rheli_minmax[index] = zone.rheli_minmax;
+
+  std::vector<std::pair<Quantity, vtkSmartPointer<vtkDataArray>>> arrays;
+  if (zone.vorticity) arrays.emplace_back(Quantity::Vorticity, zone.vorticity);
+  arrays.emplace_back(Quantity::Helicity, zone.helicity);
+  arrays.emplace_back(Quantity::RelativeHelicity, zone.relative_helicity);
+
+  std::stable_partition(arrays.begin(), arrays.end(), [requested](const auto &array) {
+    return array.first != requested;
+  });
+
+  for (auto &[quantity, array] : arrays) {
+    cache_array(array_key(index, quantity), std::move(array));
+  }
 
 }
 
 void
-Model::setup_ugrid_calculations(int index) {
+Model::cache_array(size_t key, vtkSmartPointer<vtkDataArray> array, FieldList::FieldPtr field) {
 
-  std::cout << "setup_ugrid_calculations()" << std::endl;
+  // GetActualMemorySize() is in kibibytes.
+  size_t bytes = (size_t) array->GetActualMemorySize() * 1024;
 
-  vtkSmartPointer<vtkGradientFilter> vorticity = vtkGradientFilter::New();
+  auto it = _arrays.find(key);
+  if (it != _arrays.end()) {
+    _array_bytes -= it->second.bytes;
+    _array_lru.erase(it->second.lru);
+    _arrays.erase(it);
+  }
 
-  std::string mag_name = field_name("m", index);
-  std::string vort_name = field_name("v", index);
-  std::string heli_name = field_name("h", index);
-  std::string rheli_name = field_name("rh", index);
+  // An array with the same name replaces the old one.
+  _ugrid->GetPointData()->AddArray(array);
 
-  // Vorticity computation.
+  _array_lru.push_front(key);
+  _arrays.emplace(key, CachedArray{std::move(array), std::move(field), bytes, _array_lru.begin()});
+  _array_bytes += bytes;
 
-  vorticity->ComputeVorticityOn();
-  vorticity->SetInputArrayToProcess(0, 0, 0, 0, mag_name.c_str());
-  vorticity->SetVorticityArrayName(vort_name.c_str());
-  vorticity->SetInputData(_ugrid);
-  vorticity->Update();
+}
 
-  // Helicity computation.
+void
+Model::evict_arrays(std::optional<size_t> keep) {
 
-  vtkSmartPointer<vtkArrayCalculator> helicity =
-      vtkArrayCalculator::New();
+  vtkPointData *point_data = _ugrid->GetPointData();
 
-  std::stringstream ss_h_func;
-  ss_h_func << "dot(" << mag_name << ", " << vort_name << ")";
+  auto it = _array_lru.end();
+  while (_array_bytes > _array_budget && it != _array_lru.begin()) {
 
-  helicity->SetAttributeTypeToPointData();
-  helicity->AddVectorArrayName(mag_name.c_str());
-  helicity->AddVectorArrayName(vort_name.c_str());
-  helicity->SetResultArrayName(heli_name.c_str());
-  helicity->SetFunction(ss_h_func.str().c_str());
-  helicity->SetInputData(vorticity->GetOutput());
-  helicity->Update();
+    --it;
 
-  // Relative helicity computation.
+    size_t key = *it;
+    auto &cached = _arrays.at(key);
 
-  vtkSmartPointer<vtkArrayCalculator> relative_helicity =
-      vtkArrayCalculator::New();
+    if (key == keep
+        || cached.array == point_data->GetScalars()
+        || cached.array == point_data->GetVectors()) {
+      continue;
+    }
 
-  std::stringstream ss_rh_func;
-  ss_rh_func << "dot(" << mag_name << ", " << vort_name << ")";
-  ss_rh_func << "/";
-  ss_rh_func << "mag(" << vort_name << ")";
+    // The surface shares the grid's arrays, so it has to let go of the array
+    // too. The cache then holds the last reference, and erasing the entry
+    // frees the array's memory.
+    point_data->RemoveArray(cached.array->GetName());
+    if (_surface) _surface->GetPointData()->RemoveArray(cached.array->GetName());
+    assert(cached.array->GetReferenceCount() == 1 && "An evicted array is still referenced.");
 
-  relative_helicity->SetAttributeTypeToPointData();
-  relative_helicity->AddVectorArrayName(mag_name.c_str());
-  relative_helicity->AddVectorArrayName(vort_name.c_str());
-  relative_helicity->SetResultArrayName(rheli_name.c_str());
-  relative_helicity->SetFunction(ss_rh_func.str().c_str());
-  relative_helicity->SetInputData(vorticity->GetOutput());
-  relative_helicity->Update();
+    _array_bytes -= cached.bytes;
+    _arrays.erase(key);
+    it = _array_lru.erase(it);
 
-  // Add helicity field
+  }
 
-  vtkUnstructuredGrid *hug =
-      vtkUnstructuredGrid::SafeDownCast(helicity->GetOutput());
+}
 
-  vtkSmartPointer<vtkDoubleArray> hug_array =
-      vtkDoubleArray::SafeDownCast(
-          hug->GetPointData()->GetArray(heli_name.c_str())
-      );
+void
+Model::update_surface_point_data() {
 
-  vtkSmartPointer<vtkDoubleArray> hug_darray = vtkDoubleArray::New();
-  hug_darray->SetName(heli_name.c_str());
-  hug_darray->SetNumberOfComponents(1);
-  hug_darray->SetNumberOfTuples(hug_array->GetNumberOfTuples());
+  if (!_surface) return;
+
+  _surface->GetPointData()->ShallowCopy(_ugrid->GetPointData());
+  _surface->Modified();
 
-  for (vtkIdType i = 0; i < hug_array->GetNumberOfTuples(); ++i) {
-    hug_darray->SetValue(i, hug_array->GetTuple(i)[0]);
+}
+
+void
+Model::check_zone(int index) const {
+
+  if (!_ugrid) {
+    throw std::logic_error("The arrays of a zone can only be computed once the grid has been set up.");
   }
-  double hrange[2];
-  hug_darray->GetRange(hrange);
-  _ugrid->GetPointData()->AddArray(hug_darray);
-  _heli_minmax[heli_name] = {.min = hrange[0], .max = hrange[1]};
 
-  // Add relative helicity field
+  if (index < 0 || (size_t) index >= _field_list.n_fields()) {
+    throw std::out_of_range("There is no zone " + std::to_string(index) + ".");
+  }
 
-  vtkUnstructuredGrid *rhug =
-      vtkUnstructuredGrid::SafeDownCast(relative_helicity->GetOutput());
+}
 
-  vtkSmartPointer<vtkDoubleArray> rhug_array =
-      vtkDoubleArray::SafeDownCast(
-          rhug->GetPointData()->GetArray(rheli_name.c_str())
-      );
+size_t
+Model::array_key(int index, Quantity quantity) {
+  return 4 * (size_t) index + (size_t) quantity;
+}
 
-  vtkSmartPointer<vtkDoubleArray> rhug_darray = vtkDoubleArray::New();
-  rhug_darray->SetName(rheli_name.c_str());
-  rhug_darray->SetNumberOfComponents(1);
-  rhug_darray->SetNumberOfTuples(rhug_array->GetNumberOfTuples());
+std::string
+Model::array_name(int index, Quantity quantity) const {
 
-  for (vtkIdType i = 0; i < rhug_array->GetNumberOfTuples(); ++i) {
-    rhug_darray->SetValue(i, rhug_array->GetTuple(i)[0]);
+  switch (quantity) {
+    case Quantity::Magnetisation: return field_name("m", index);
+    case Quantity::Vorticity: return field_name("v", index);
+    case Quantity::Helicity: return field_name("h", index);
+    case Quantity::RelativeHelicity: return field_name("rh", index);
   }
-  double rhrange[2];
-  rhug_darray->GetRange(rhrange);
-  _ugrid->GetPointData()->AddArray(rhug_darray);
-  _rheli_minmax[rheli_name] = {.min = rhrange[0], .max = rhrange[1]};
-
-  // Push back the names for magnetization, vorticity, helicity and relative
-  // helicity.
-  _mag_names.push_back(mag_name);
-  _vort_names.push_back(vort_name);
-  _heli_names.push_back(heli_name);
-  _rheli_names.push_back(rheli_name);
+
+  return {};
 
 }
 
@@ -5,34 +5,50 @@
 #ifndef MMPPT_TOY_QT_VTK_EX005_MODEL_HPP_
 #define MMPPT_TOY_QT_VTK_EX005_MODEL_HPP_
 
+#include <cassert>
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <list>
 #include <regex>
+#include <span>
 #include <sstream>
+#include <type_traits>
 #include <unordered_set>
 #include <utility>
 #include <optional>
 
 #include <vtkActor.h>
-#include <vtkArrayCalculator.h>
 #include <vtkArrowSource.h>
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetAttributes.h>
 #include <vtkDataSetMapper.h>
 #include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
 #include <vtkGlyph3D.h>
-#include <vtkGradientFilter.h>
 #include <vtkLookupTable.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
+#include <vtkSOADataArrayTemplate.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+#include <vtkTypeTraits.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkUnstructuredGrid.h>
 
 #include "aliases.hpp"
 #include "config_consts.h"
 #include "field.hpp"
+#include "load_progress.hpp"
 #include "mesh.hpp"
 #include "palettes.hpp"
+#include "parallel.hpp"
 
 /**
  * A model consists of a mesh and a field.
@@ -46,17 +62,47 @@ class Model {
     double max;
   };
 
-  Model(v_list vcl, tet_list til, sm_list sml) :
+  /**
+   * The quantities of a zone that can be added to the unstructured grid.
+   */
+  enum class Quantity {
+    // The field itself, m.
+    Magnetisation,
+    // The curl of the field, v.
+    Vorticity,
+    // The helicity, dot(m, v).
+    Helicity,
+    // The relative helicity, dot(m, v) / mag(v).
+    RelativeHelicity
+  };
+
+  /**
+   * The default amount of memory, in bytes, that the arrays of zones added
+   * to the unstructured grid may use.
+   */
+  static constexpr size_t default_array_budget = size_t{512} << 20;
+
+  /**
+   * The default number of zones whose arrays are computed when the graphics
+   * are prepared, one batch of the curl operator.
+   */
+  static constexpr size_t default_prefetch_count = CurlOperator::batch_size;
+
+  Model(v_list vcl, Connectivity til, sm_list sml) :
       _mesh{std::move(vcl),
             std::move(til),
             std::move(sml)} {}
 
-  Model(v_list vcl, tet_list til, sm_list sml, FieldList field_list) :
+  Model(v_list vcl, Connectivity til, sm_list sml, FieldList field_list) :
       _mesh{std::move(vcl),
             std::move(til),
             std::move(sml)},
       _field_list{std::move(field_list)} {}
 
+  Model(Mesh mesh, FieldList field_list) :
+      _mesh{std::move(mesh)},
+      _field_list{std::move(field_list)} {}
+
   [[nodiscard]] const Mesh &
   mesh() const;
 
@@ -66,10 +112,47 @@ class Model {
   void
   add_field(Field field);
 
+  /**
+   * Set how resident zones of a lazily loaded model are held, see
+   * FieldList::set_encoding().
+   * @param encoding the encoding.
+   */
+  void
+  set_field_encoding(FieldList::Encoding encoding);
+
+  /**
+   * Renumber the vertices and tetrahedra of the model to improve locality,
+   * the vectors of every field are reordered to match. The original indices
+   * are kept by the mesh (see Mesh::vertex_order()).
+   * @param ordering the ordering.
+   * @throws std::logic_error if the graphics have already been prepared.
+   */
+  void
+  reorder(Ordering ordering);
+
   //--------------------------------------------------------------------------
   // VTK graphics related functions
   //--------------------------------------------------------------------------
 
+  /**
+   * Build the unstructured grid and compute the arrays of the first zones
+   * (see set_prefetch_count()). This does not create any rendering objects,
+   * so it may be called from a worker thread before the model is handed to
+   * the GUI.
+   * @param progress optional progress reporting and cancellation.
+   * @throws LoadCancelledException if cancellation has been requested.
+   */
+  void
+  prepare_graphics(LoadProgress *progress = nullptr);
+
+  [[nodiscard]] bool
+  graphics_prepared() const;
+
+  /**
+   * Create the mappers and actors used to display the model, the grid is
+   * prepared first if that has not already been done. This must be called on
+   * the GUI thread.
+   */
   void
   enable_graphics();
 
@@ -85,17 +168,151 @@ class Model {
   [[nodiscard]] vtkSmartPointer<vtkUnstructuredGrid>
   ugrid() const;
 
+  [[nodiscard]] vtkSmartPointer<vtkPolyDataMapper>
+  surface_mapper() const;
+
+  /**
+   * Retrieve the surface of the unstructured grid, the faces on the boundary
+   * of the mesh and on the interfaces between sub-meshes. It shares the
+   * grid's points and point data.
+   * @return the surface.
+   */
+  [[nodiscard]] vtkSmartPointer<vtkPolyData>
+  surface() const;
+
+  /**
+   * Choose what the unstructured grid actor renders, the extracted surface
+   * (the default) or the whole grid.
+   * @param surface_only true to render the surface, false for the grid.
+   */
+  void
+  set_ugrid_surface_only(bool surface_only);
+
+  [[nodiscard]] bool
+  ugrid_surface_only() const;
+
+  /**
+   * Show or hide the tetrahedra of a sub-mesh. The grid is not rebuilt, its
+   * hidden cells and the vertices that only they use are flagged in ghost
+   * arrays (so they are skipped by the mappers and the arrow glyphs) and
+   * the surface is re-assembled from the boundary and interface faces that
+   * separate shown from hidden tetrahedra.
+   * @param index the number of the sub-mesh (see Mesh::submeshes()).
+   * @param visible true to show the sub-mesh, false to hide it.
+   * @throws std::logic_error if the graphics have not been prepared.
+   */
+  void
+  set_submesh_visible(size_t index, bool visible);
+
+  /**
+   * Check whether a sub-mesh is shown.
+   * @param index the number of the sub-mesh (see Mesh::submeshes()).
+   * @return true if the sub-mesh is shown, otherwise false.
+   */
+  [[nodiscard]] bool
+  submesh_visible(size_t index) const;
+
   [[nodiscard]] std::string
   field_name(const std::string &prefix, int index) const;
 
   [[nodiscard]] std::optional<int>
   field_name_index(const std::string &name) const;
 
-  [[nodiscard]] std::unordered_map<std::string, MinMax>
-  heli_minmax() const;
+  /**
+   * Retrieve the array of a zone's quantity. Arrays are computed the first
+   * time they are asked for and added to the unstructured grid's point data
+   * (named as field_name()), they are kept in a least recently used cache
+   * and removed from the point data again when the cache outgrows its
+   * budget (see set_array_budget()). The arrays of the active zone are
+   * never removed. The array should not be held on to, the memory of an
+   * evicted array is only freed once nothing references it (this is
+   * checked in debug builds).
+   * @param index the index of the zone.
+   * @param quantity the quantity.
+   * @return the array.
+   * @throws std::logic_error if the graphics have not been prepared.
+   * @throws std::out_of_range if there is no such zone.
+   */
+  vtkSmartPointer<vtkDataArray>
+  zone_array(int index, Quantity quantity);
+
+  /**
+   * Compute the helicity and relative helicity of several zones at once,
+   * ahead of them being displayed. Batches of zones are computed
+   * concurrently, as many at a time as fit in the array budget. Zones that
+   * do not fit in the budget are computed, but not kept.
+   * @param first the index of the first zone.
+   * @param count the number of zones.
+   * @param progress optional progress reporting and cancellation.
+   * @throws std::logic_error if the graphics have not been prepared.
+   * @throws LoadCancelledException if cancellation has been requested.
+   */
+  void
+  prefetch_zones(int first, int count, LoadProgress *progress = nullptr);
+
+  /**
+   * Display a zone, its field becomes the grid's active vectors and its
+   * relative helicity the active scalars.
+   * @param index the index of the zone.
+   * @throws std::logic_error if the graphics have not been prepared.
+   * @throws std::out_of_range if there is no such zone.
+   */
+  void
+  set_active_zone(int index);
+
+  /**
+   * Retrieve the displayed zone.
+   * @return the index of the zone, or -1 if there are no zones.
+   */
+  [[nodiscard]] int
+  active_zone() const;
+
+  /**
+   * Set the amount of memory that the arrays of zones may use, arrays are
+   * removed straight away if they no longer fit.
+   * @param budget the budget in bytes.
+   */
+  void
+  set_array_budget(size_t budget);
+
+  [[nodiscard]] size_t
+  array_budget() const;
+
+  /**
+   * Set the number of zones whose arrays are computed, concurrently, when
+   * the graphics are prepared. Other zones are computed when they are asked
+   * for.
+   * @param count the number of zones, at least the first zone is computed.
+   */
+  void
+  set_prefetch_count(size_t count);
+
+  [[nodiscard]] size_t
+  prefetch_count() const;
 
-  [[nodiscard]] std::unordered_map<std::string, MinMax>
-  rheli_minmax() const;
+  /**
+   * Retrieve the amount of memory used by the arrays of zones.
+   * @return the number of bytes.
+   */
+  [[nodiscard]] size_t
+  resident_array_bytes() const;
+
+  /**
+   * Retrieve the range of a zone's helicity, it is computed if need be.
+   * @param index the index of the zone.
+   * @return the minimum and maximum.
+   */
+  [[nodiscard]] MinMax
+  heli_minmax(int index);
+
+  /**
+   * Retrieve the range of a zone's relative helicity, it is computed if need
+   * be.
+   * @param index the index of the zone.
+   * @return the minimum and maximum.
+   */
+  [[nodiscard]] MinMax
+  rheli_minmax(int index);
 
   [[nodiscard]] double
   length_scale() const;
@@ -126,6 +343,10 @@ class Model {
 
  private:
 
+  // VTK array type of field vectors and derived fields, this matches the
+  // precision of field_scalar.
+  using FieldArray = std::conditional_t<std::is_same_v<field_scalar, float>, vtkFloatArray, vtkDoubleArray>;
+
   Mesh _mesh;
 
   FieldList _field_list;
@@ -137,27 +358,89 @@ class Model {
   // Field names zero-padding length.
   int _zero_pad_length{5};
 
+  // Flag to indicate that the grid and derived fields have been built.
+  bool _graphics_prepared{false};
+
   // Flag to indicate that graphics are enabled.
   bool _graphics_enabled{false};
 
-  // Field name.
-  std::vector<std::string> _mag_names;
-  std::vector<std::string> _vort_names;
-  std::vector<std::string> _heli_names;
-  std::vector<std::string> _rheli_names;
+  // Field helicity min/max values, by zone. These are kept when a zone's
+  // arrays are evicted.
+  std::unordered_map<int, MinMax> _heli_minmax;
 
-  // Field helicity min/max values
-  std::unordered_map<std::string, MinMax> _heli_minmax;
-
-  // Field relative helicity min/max value (absolute range [-1, 1]).
-  std::unordered_map<std::string, MinMax> _rheli_minmax;
+  // Field relative helicity min/max value (absolute range [-1, 1]), by zone.
+  std::unordered_map<int, MinMax> _rheli_minmax;
 
   // Pointer to a VTK unstructured grid.
   vtkSmartPointer<vtkUnstructuredGrid> _ugrid;
 
+  // An array of a zone that is part of the unstructured grid's point data.
+  struct CachedArray {
+    vtkSmartPointer<vtkDataArray> array;
+    // The field whose memory the array shares, if any.
+    FieldList::FieldPtr field;
+    size_t bytes;
+    std::list<size_t>::iterator lru;
+  };
+
+  // Cached arrays by array_key(), and their keys, most recently used first.
+  std::unordered_map<size_t, CachedArray> _arrays;
+  std::list<size_t> _array_lru;
+
+  // Memory used by the cached arrays, and the most that they may use.
+  size_t _array_bytes{0};
+  size_t _array_budget{default_array_budget};
+
+  // The displayed zone.
+  int _active_zone{-1};
+
+  // The number of zones computed when the graphics are prepared.
+  size_t _prefetch_count{default_prefetch_count};
+
+  // Storage reused by every curl that zone_array() computes.
+  CurlOperator::Scratch _curl_scratch;
+  fv_list _curl;
+
   // Pointer to an unstructured grid dataset mapper.
   vtkSmartPointer<vtkDataSetMapper> _ugrid_ds_mapper;
 
+  // Boundary and sub-mesh interface surface of the unstructured grid.
+  vtkSmartPointer<vtkPolyData> _surface;
+
+  // A face of the surface, wound so that its normal points away from the
+  // sub-mesh on its inner side.
+  struct SurfaceFace {
+    std::array<vtkTypeInt64, 3> corners;
+    uint32_t inner;
+    uint32_t outer;
+  };
+
+  // Marks the outer side of a face on the boundary of the mesh.
+  static constexpr uint32_t no_submesh = std::numeric_limits<uint32_t>::max();
+
+  // Every face that can be part of the surface, i.e. every boundary and
+  // sub-mesh interface face.
+  std::vector<SurfaceFace> _surface_faces;
+
+  // Pointer to the surface's mapper.
+  vtkSmartPointer<vtkPolyDataMapper> _surface_mapper;
+
+  // Whether each sub-mesh is shown.
+  std::vector<bool> _submesh_visible;
+
+  // The number of shown tetrahedra that use each vertex, empty until a
+  // sub-mesh is first hidden.
+  std::vector<uint32_t> _vertex_visible_tets;
+
+  // Ghost arrays of the unstructured grid that flag hidden cells and
+  // points, null until a sub-mesh is first hidden.
+  vtkSmartPointer<vtkUnsignedCharArray> _cell_ghosts;
+  vtkSmartPointer<vtkUnsignedCharArray> _point_ghosts;
+
+  // Flag to indicate that the actor renders the surface rather than the
+  // whole grid.
+  bool _ugrid_surface_only{true};
+
   // Pointer to a VTK unstructured grid actor.
   vtkSmartPointer<vtkActor> _ugrid_actor;
 
@@ -189,29 +472,120 @@ class Model {
   // Arrow scale.
   double _arrow_scale{.005};
 
+  // The derived arrays computed for a zone, before they are added to the
+  // grid. The vorticity is null when it is not kept (see prefetch_zones()).
+  struct ZoneArrays {
+    vtkSmartPointer<FieldArray> vorticity;
+    vtkSmartPointer<FieldArray> helicity;
+    vtkSmartPointer<FieldArray> relative_helicity;
+    MinMax heli_minmax;
+    MinMax rheli_minmax;
+  };
+
   /**
-   * Function to set up the unstructured grid associated with this mesh.
+   * Function to set up the unstructured grid associated with this mesh, the
+   * grid's points and connectivity share the mesh's storage.
    */
   void
   setup_ugrid();
 
   /**
-   * Function to set up magnetization vector data.
+   * Function to extract the surface of the unstructured grid. Only the
+   * surface triangles are stored, points and point data are the grid's.
    */
   void
-  setup_ugrid_fields();
+  setup_surface();
 
   /**
-   * Unstructured grid.
+   * Function to assemble the surface's triangles from the surface faces
+   * that separate shown from hidden (or no) tetrahedra.
    */
   void
-  setup_ugrid_field(int index, const Field &field);
+  update_surface();
 
   /**
-   * Unstructured grid calculations.
+   * Function to set up the mapper and actor of the unstructured grid.
    */
   void
-  setup_ugrid_calculations(int index);
+  setup_ugrid_actor();
+
+  /**
+   * Function to set up magnetization vector data, only the first zone's
+   * arrays are computed.
+   */
+  void
+  setup_ugrid_fields(LoadProgress *progress);
+
+  /**
+   * Create the VTK array of a field. The array wraps the field's memory
+   * rather than copying it, apart from quantised fields, which are decoded
+   * and released.
+   * @param field the field, this is reset if the field does not need to be
+   *              kept alive.
+   * @return the array.
+   */
+  [[nodiscard]] static vtkSmartPointer<vtkDataArray>
+  ugrid_field_array(FieldList::FieldPtr &field);
+
+  /**
+   * Unstructured grid calculations, the helicity and relative helicity of a
+   * field from its curl (see CurlOperator). This does not modify the model,
+   * so it may be called for several fields at once.
+   * @param index the index of the field.
+   * @param field the field.
+   * @param vorticity the curl of the field.
+   * @param keep_vorticity true to return the vorticity as an array too.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   * @return the zone's arrays.
+   */
+  [[nodiscard]] ZoneArrays
+  setup_ugrid_calculations(int index, const Field &field, std::span<const fv> vorticity,
+                           bool keep_vorticity, size_t n_threads) const;
+
+  /**
+   * Add the derived arrays of a zone to the cache, the requested quantity is
+   * added last so that it is the most recently used.
+   * @param index the index of the zone.
+   * @param zone the zone's arrays.
+   * @param requested the quantity that was asked for.
+   */
+  void
+  cache_zone_arrays(int index, ZoneArrays zone, Quantity requested);
+
+  /**
+   * Add an array to the cache and to the grid's point data, an array that is
+   * already cached under the same key is replaced.
+   */
+  void
+  cache_array(size_t key, vtkSmartPointer<vtkDataArray> array, FieldList::FieldPtr field = nullptr);
+
+  /**
+   * Remove the least recently used arrays from the cache and the grid's point
+   * data until the cache fits in its budget. The active scalars and vectors
+   * are never removed.
+   * @param keep an array that must not be removed either.
+   */
+  void
+  evict_arrays(std::optional<size_t> keep = std::nullopt);
+
+  /**
+   * Share the grid's point data arrays with the surface again, after arrays
+   * have been added or removed.
+   */
+  void
+  update_surface_point_data();
+
+  /**
+   * Throw unless the graphics have been prepared and a zone exists.
+   */
+  void
+  check_zone(int index) const;
+
+  [[nodiscard]] static size_t
+  array_key(int index, Quantity quantity);
+
+  [[nodiscard]] std::string
+  array_name(int index, Quantity quantity) const;
 
   void
   setup_arrows();
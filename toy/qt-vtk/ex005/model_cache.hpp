@@ -0,0 +1,529 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_MODEL_CACHE_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_MODEL_CACHE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "field.hpp"
+#include "load_tecplot.hpp"
+#include "mapped_file.hpp"
+#include "model.hpp"
+
+/**
+ * A binary cache of a loaded model that is written next to its source file
+ * (or in to a cache directory) after the first successful parse. Subsequent
+ * loads map the cache and build the model without parsing any text.
+ *
+ * The cache consists of a fixed size header followed by raw little-endian
+ * arrays, each aligned to 64 bytes:
+ *   - vertex coordinates, n_verts x 3 doubles,
+ *   - tetrahedra (0-based), n_elems x 4 uint32 or uint64 (see index_size),
+ *   - sub-mesh indices, n_elems uint64,
+ *   - fields, n_zones x n_verts x 3 field_scalar values,
+ *   - zone titles, for each zone a uint64 length followed by the characters.
+ *
+ * The header records the size, modification time and a content hash of the
+ * source, a cache whose header does not match its source is ignored and
+ * rewritten, as is a cache that was written with a different field
+ * precision. The content hash covers the size of the source and sixteen
+ * evenly spaced 64KiB samples of it rather than every byte, so that checking
+ * a multi-GB source stays cheap.
+ */
+class ModelCache {
+
+ public:
+
+  /**
+   * Cache file format version, bump this whenever the layout changes.
+   */
+  static constexpr uint32_t format_version = 3;
+
+  /**
+   * The suffix appended to the source file name to form the cache file name.
+   */
+  static constexpr std::string_view suffix{".mmppt-cache"};
+
+  /**
+   * Create a new model cache.
+   * @param cache_dir directory in which cache files are kept, if this is not
+   *                  given cache files are written next to their source.
+   */
+  explicit ModelCache(std::optional<std::filesystem::path> cache_dir = std::nullopt) :
+      _cache_dir{std::move(cache_dir)} {}
+
+  /**
+   * Load a model from the cache if there is an up-to-date cache for the
+   * source, otherwise parse the source. No cache is written here, since
+   * that means decoding every zone, see update().
+   * @param source_file the tecplot file.
+   * @param max_resident the maximum number of decoded zones kept in memory.
+   * @param progress optional progress reporting and cancellation.
+   * @return the model.
+   */
+  [[nodiscard]] Model
+  load_or_read(const std::string &source_file,
+               size_t max_resident = FieldList::default_max_resident,
+               LoadProgress *progress = nullptr) const {
+
+    auto model = load(source_file, max_resident);
+    if (model.has_value()) return std::move(model.value());
+
+    return TecplotFileLoader::read_lazy(source_file, max_resident, progress);
+
+  }
+
+  /**
+   * Write the cache for a source file unless there already is an up-to-date
+   * one. The source is read again, one zone at a time, so that this can run
+   * in the background without touching a model that is in use.
+   * @param source_file the tecplot file.
+   * @param progress optional progress reporting and cancellation.
+   * @return true if the cache is up-to-date, otherwise false.
+   * @throws LoadCancelledException if cancellation has been requested.
+   */
+  bool
+  update(const std::string &source_file, LoadProgress *progress = nullptr) const {
+
+    if (is_current(source_file)) return true;
+
+    return store(source_file, TecplotFileLoader::read_lazy(source_file, 1, progress), progress);
+
+  }
+
+  /**
+   * Test whether there is an up-to-date cache for a source file.
+   * @param source_file the tecplot file.
+   * @return true if the cache matches its source, otherwise false.
+   */
+  [[nodiscard]] bool
+  is_current(const std::string &source_file) const {
+
+    if constexpr (std::endian::native != std::endian::little) return false;
+
+    auto source_header = header_for_source(source_file);
+    if (!source_header.has_value()) return false;
+
+    MappedFile mapped_file{cache_file(source_file).string(), false};
+    return mapped_file.is_mapped() && read_header(mapped_file, source_header.value()).has_value();
+
+  }
+
+  /**
+   * Load a model from the cache.
+   * @param source_file the tecplot file.
+   * @param max_resident the maximum number of decoded zones kept in memory.
+   * @return the model, or nothing if there is no up-to-date cache.
+   */
+  [[nodiscard]] std::optional<Model>
+  load(const std::string &source_file,
+       size_t max_resident = FieldList::default_max_resident) const {
+
+    if constexpr (std::endian::native != std::endian::little) return std::nullopt;
+
+    auto source_header = header_for_source(source_file);
+    if (!source_header.has_value()) return std::nullopt;
+
+    auto mapped_file = std::make_shared<const MappedFile>(cache_file(source_file).string(), false);
+    if (!mapped_file->is_mapped()) return std::nullopt;
+
+    auto cache_header = read_header(*mapped_file, source_header.value());
+    if (!cache_header.has_value()) return std::nullopt;
+    const Header &header = cache_header.value();
+
+    size_t n_verts = header.n_verts;
+    size_t n_elems = header.n_elems;
+
+    // A damaged cache can still match its source, so every array has to be
+    // checked against the size of the file before it is read.
+    uint64_t file_size = mapped_file->size();
+    if (!in_bounds(header.verts_offset, n_verts, sizeof(vert), file_size)
+        || !in_bounds(header.tets_offset, n_elems, 4 * header.index_size, file_size)
+        || !in_bounds(header.submesh_offset, n_elems, sizeof(size_t), file_size)
+        || n_verts > file_size / sizeof(fv)
+        || !in_bounds(header.fields_offset, header.n_zones, n_verts * sizeof(fv), file_size)) {
+      return std::nullopt;
+    }
+
+    auto titles = read_titles(*mapped_file, header);
+    if (!titles.has_value()) return std::nullopt;
+
+    v_list vcl(n_verts);
+    std::memcpy(vcl.data(), mapped_file->data() + header.verts_offset, n_verts * sizeof(vert));
+
+    Connectivity til = header.index_size == sizeof(uint32_t)
+                       ? Connectivity{tet32_list(n_elems)}
+                       : Connectivity{tet_list(n_elems)};
+    std::memcpy(til.data(), mapped_file->data() + header.tets_offset, 4 * n_elems * header.index_size);
+
+    sm_list sml(n_elems);
+    std::memcpy(sml.data(), mapped_file->data() + header.submesh_offset, n_elems * sizeof(size_t));
+
+    FieldList field_list{
+        std::make_shared<CachedFieldSource>(mapped_file, header, std::move(titles.value())),
+        max_resident
+    };
+
+    return Model{std::move(vcl), std::move(til), std::move(sml), std::move(field_list)};
+
+  }
+
+  /**
+   * Write the cache for a model.
+   * @param source_file the tecplot file that the model was read from.
+   * @param model the model.
+   * @param progress optional progress reporting and cancellation, every
+   *                 zone is decoded in order to be written.
+   * @return true if the cache was written, otherwise false.
+   * @throws LoadCancelledException if cancellation has been requested, the
+   *                                partly written cache is removed.
+   */
+  bool
+  store(const std::string &source_file, const Model &model, LoadProgress *progress = nullptr) const {
+
+    if constexpr (std::endian::native != std::endian::little) return false;
+
+    auto source_header = header_for_source(source_file);
+    if (!source_header.has_value()) return false;
+
+    const auto &mesh = model.mesh();
+    const auto &field_list = model.field_list();
+
+    // The cache stands in for the source file, so it keeps its numbering.
+    if (mesh.is_reordered()) return false;
+
+    Header header = source_header.value();
+    header.n_verts = mesh.vcl().size();
+    header.n_elems = mesh.til().size();
+    header.n_zones = field_list.n_fields();
+    header.index_size = mesh.til().index_size();
+
+    header.verts_offset = align(sizeof(Header));
+    header.tets_offset = align(header.verts_offset + header.n_verts * sizeof(vert));
+    header.submesh_offset = align(header.tets_offset + 4 * header.n_elems * header.index_size);
+    header.fields_offset = align(header.submesh_offset + header.n_elems * sizeof(size_t));
+    header.titles_offset = align(header.fields_offset + header.n_zones * header.n_verts * sizeof(fv));
+
+    auto path = cache_file(source_file);
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    bool ok;
+
+    try {
+      std::ofstream fout(tmp_path, std::ios::binary | std::ios::trunc);
+      if (!fout) return false;
+
+      // The header is rewritten with the final size once everything is out.
+      write_at(fout, 0, &header, sizeof(Header));
+      write_at(fout, header.verts_offset, mesh.vcl().data(), header.n_verts * sizeof(vert));
+      write_at(fout, header.tets_offset, mesh.til().data(), 4 * header.n_elems * header.index_size);
+      write_at(fout, header.submesh_offset, mesh.sml().data(), header.n_elems * sizeof(size_t));
+
+      if (progress) progress->start("Writing cache", header.n_zones);
+
+      std::vector<std::string> titles;
+      fv_list scratch;
+      for (size_t i = 0; i < header.n_zones; ++i) {
+        auto field = field_list.field(i);
+        if (field->size() != header.n_verts) break;
+        write_at(fout,
+                 header.fields_offset + i * header.n_verts * sizeof(fv),
+                 field->interleaved(scratch).data(),
+                 header.n_verts * sizeof(fv));
+        titles.push_back(field->annotation());
+        if (progress) progress->advance(1);
+      }
+
+      fout.seekp((std::streamoff) header.titles_offset);
+      for (const auto &title : titles) {
+        uint64_t length = title.size();
+        fout.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        fout.write(title.data(), (std::streamsize) title.size());
+      }
+
+      header.file_size = (uint64_t) fout.tellp();
+      write_at(fout, 0, &header, sizeof(Header));
+
+      ok = fout.good() && titles.size() == header.n_zones;
+    } catch (...) {
+      std::filesystem::remove(tmp_path, ec);
+      throw;
+    }
+
+    if (ok) std::filesystem::rename(tmp_path, path, ec);
+
+    if (!ok || ec) {
+      std::filesystem::remove(tmp_path, ec);
+      return false;
+    }
+
+    return true;
+
+  }
+
+  /**
+   * Retrieve the name of the cache file for a source file.
+   * @param source_file the tecplot file.
+   * @return the cache file name.
+   */
+  [[nodiscard]] std::filesystem::path
+  cache_file(const std::string &source_file) const {
+
+    std::filesystem::path source_path = std::filesystem::absolute(source_file);
+
+    if (!_cache_dir.has_value()) {
+      auto path = source_path;
+      path += suffix;
+      return path;
+    }
+
+    // Distinguish sources with the same name in different directories.
+    size_t path_hash = std::hash<std::string>{}(source_path.string());
+    std::string name = source_path.filename().string() + "." + to_hex(path_hash);
+
+    return _cache_dir.value() / (name + std::string(suffix));
+
+  }
+
+ private:
+
+  static constexpr std::array<char, 8> magic{'M', 'M', 'P', 'P', 'T', 'M', 'C', '\0'};
+
+  static constexpr size_t alignment = 64;
+
+  /**
+   * Cache file header, every field is stored little-endian.
+   */
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t field_scalar_size;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;
+    uint64_t file_size;
+    uint64_t n_verts;
+    uint64_t n_elems;
+    uint64_t n_zones;
+    uint64_t verts_offset;
+    uint64_t tets_offset;
+    uint64_t submesh_offset;
+    uint64_t fields_offset;
+    uint64_t titles_offset;
+    uint32_t index_size;
+    uint32_t reserved;
+  };
+
+  static_assert(sizeof(size_t) == sizeof(uint64_t),
+                "The model cache stores indices as raw 64-bit values.");
+
+  /**
+   * Field source that copies zones straight out of a mapped cache file.
+   */
+  class CachedFieldSource : public FieldSource {
+
+   public:
+
+    CachedFieldSource(std::shared_ptr<const MappedFile> mapped_file, const Header &header,
+                      std::vector<std::string> titles) :
+        _mapped_file{std::move(mapped_file)},
+        _n_verts{header.n_verts},
+        _fields{_mapped_file->data() + header.fields_offset},
+        _titles{std::move(titles)} {}
+
+    [[nodiscard]] size_t
+    n_fields() const override { return _titles.size(); }
+
+    [[nodiscard]] Field
+    load(size_t index) const override {
+
+      fv_list vectors(_n_verts);
+      std::memcpy(vectors.data(), _fields + index * _n_verts * sizeof(fv), _n_verts * sizeof(fv));
+
+      return Field{_titles.at(index), std::move(vectors)};
+
+    }
+
+   private:
+
+    // The mapped cache file.
+    std::shared_ptr<const MappedFile> _mapped_file;
+
+    // The number of vertices in each field.
+    size_t _n_verts;
+
+    // Start of the field data.
+    const char *_fields;
+
+    // The title of each zone.
+    std::vector<std::string> _titles;
+
+  };
+
+  // Directory in which cache files are kept, next to the source if not set.
+  std::optional<std::filesystem::path> _cache_dir;
+
+  static uint64_t
+  align(uint64_t offset) {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  static std::string
+  to_hex(size_t value) {
+    std::string hex(2 * sizeof(size_t), '0');
+    for (size_t i = hex.size(); i-- > 0; value >>= 4) {
+      hex[i] = "0123456789abcdef"[value & 0xf];
+    }
+    return hex;
+  }
+
+  /**
+   * Check that `count` items of `item_size` bytes starting at `offset` lie
+   * within a file, without overflowing.
+   */
+  static bool
+  in_bounds(uint64_t offset, uint64_t count, uint64_t item_size, uint64_t file_size) {
+    if (offset > file_size) return false;
+    return item_size == 0 || count <= (file_size - offset) / item_size;
+  }
+
+  /**
+   * Read the header of a cache file.
+   * @return the header, or nothing if it is not a header of this version for
+   *         the given source.
+   */
+  static std::optional<Header>
+  read_header(const MappedFile &mapped_file, const Header &source_header) {
+
+    if (mapped_file.size() < sizeof(Header)) return std::nullopt;
+
+    Header header{};
+    std::memcpy(&header, mapped_file.data(), sizeof(Header));
+
+    if (std::memcmp(header.magic, magic.data(), magic.size()) != 0
+        || header.version != format_version
+        || header.field_scalar_size != sizeof(field_scalar)
+        || (header.index_size != sizeof(uint32_t) && header.index_size != sizeof(uint64_t))
+        || header.source_size != source_header.source_size
+        || header.source_mtime != source_header.source_mtime
+        || header.source_hash != source_header.source_hash
+        || mapped_file.size() < header.file_size) {
+      return std::nullopt;
+    }
+
+    return header;
+
+  }
+
+  /**
+   * Read the zone titles of a cache file.
+   * @return the titles, or nothing if they run past the end of the file.
+   */
+  static std::optional<std::vector<std::string>>
+  read_titles(const MappedFile &mapped_file, const Header &header) {
+
+    uint64_t file_size = mapped_file.size();
+    uint64_t offset = header.titles_offset;
+
+    // Each title takes at least its length.
+    if (!in_bounds(offset, header.n_zones, sizeof(uint64_t), file_size)) return std::nullopt;
+
+    std::vector<std::string> titles;
+    titles.reserve(header.n_zones);
+
+    for (size_t i = 0; i < header.n_zones; ++i) {
+      uint64_t length;
+      if (!in_bounds(offset, 1, sizeof(length), file_size)) return std::nullopt;
+      std::memcpy(&length, mapped_file.data() + offset, sizeof(length));
+      offset += sizeof(length);
+      if (!in_bounds(offset, length, 1, file_size)) return std::nullopt;
+      titles.emplace_back(mapped_file.data() + offset, length);
+      offset += length;
+    }
+
+    return titles;
+
+  }
+
+  static void
+  write_at(std::ofstream &fout, uint64_t offset, const void *data, size_t n_bytes) {
+    fout.seekp((std::streamoff) offset);
+    fout.write(static_cast<const char *>(data), (std::streamsize) n_bytes);
+  }
+
+  /**
+   * 64-bit FNV-1a hash.
+   */
+  static uint64_t
+  fnv1a(const char *data, size_t n_bytes, uint64_t hash) {
+    for (size_t i = 0; i < n_bytes; ++i) {
+      hash ^= (unsigned char) data[i];
+      hash *= 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  /**
+   * Build the part of the header that identifies the source file.
+   * @return the header, or nothing if the source can not be read.
+   */
+  static std::optional<Header>
+  header_for_source(const std::string &source_file) {
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(source_file, ec);
+    if (ec) return std::nullopt;
+
+    MappedFile source{source_file, false};
+    if (!source.is_mapped()) return std::nullopt;
+
+    constexpr size_t n_samples = 16;
+    constexpr size_t sample_size = 64 * 1024;
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    uint64_t size = source.size();
+    hash = fnv1a(reinterpret_cast<const char *>(&size), sizeof(size), hash);
+
+    if (source.size() <= n_samples * sample_size) {
+      hash = fnv1a(source.data(), source.size(), hash);
+    } else {
+      size_t stride = (source.size() - sample_size) / (n_samples - 1);
+      for (size_t i = 0; i < n_samples; ++i) {
+        hash = fnv1a(source.data() + i * stride, sample_size, hash);
+      }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, magic.data(), magic.size());
+    header.version = format_version;
+    header.field_scalar_size = sizeof(field_scalar);
+    header.source_size = source.size();
+    header.source_mtime = (int64_t) mtime.time_since_epoch().count();
+    header.source_hash = hash;
+
+    return header;
+
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_MODEL_CACHE_HPP_
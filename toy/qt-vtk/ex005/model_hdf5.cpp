@@ -0,0 +1,515 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#include "model_hdf5.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <hdf5.h>
+
+#include "load_tecplot.hpp"
+#include "load_tecplot_binary.hpp"
+
+namespace {
+
+// The HDF5 library is not guaranteed to be built thread safe, so all calls
+// go through this lock. It is recursive since writing a model may load its
+// lazy fields from another HDF5 file.
+std::recursive_mutex hdf5_mutex;
+
+/**
+ * Owns an HDF5 identifier and closes it on destruction.
+ */
+class Handle {
+
+ public:
+
+  Handle(hid_t id, herr_t (*close)(hid_t), const std::string &what) :
+      _id{id}, _close{close} {
+    if (_id < 0) throw ModelHdf5Exception("HDF5 error: " + what);
+  }
+
+  Handle(const Handle &) = delete;
+
+  Handle(Handle &&other) noexcept :
+      _id{std::exchange(other._id, -1)}, _close{other._close} {}
+
+  Handle &operator=(const Handle &) = delete;
+
+  ~Handle() {
+    if (_id >= 0) {
+      std::lock_guard<std::recursive_mutex> lock{hdf5_mutex};
+      _close(_id);
+    }
+  }
+
+  operator hid_t() const { return _id; }
+
+ private:
+
+  hid_t _id;
+
+  herr_t (*_close)(hid_t);
+
+};
+
+void
+check(herr_t status, const std::string &what) {
+  if (status < 0) throw ModelHdf5Exception("HDF5 error: " + what);
+}
+
+/**
+ * The memory type of field vector components, HDF5 converts to and from the
+ * type stored in the file.
+ */
+hid_t
+native_field_type() {
+  return std::is_same_v<field_scalar, float> ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+}
+
+/**
+ * Variable length UTF-8 string type used for zone titles.
+ */
+Handle
+string_type() {
+  Handle type{H5Tcopy(H5T_C_S1), H5Tclose, "copy string type"};
+  check(H5Tset_size(type, H5T_VARIABLE), "set string size");
+  check(H5Tset_cset(type, H5T_CSET_UTF8), "set string character set");
+  return type;
+}
+
+/**
+ * Write a two dimensional dataset in one go.
+ */
+void
+write_dataset(hid_t group, const char *name, hid_t file_type, hid_t mem_type,
+              hsize_t rows, hsize_t cols, const void *data) {
+
+  std::array<hsize_t, 2> dims{rows, cols};
+  int rank = cols == 0 ? 1 : 2;
+
+  Handle space{H5Screate_simple(rank, dims.data(), nullptr), H5Sclose, "create dataspace"};
+  Handle dataset{
+      H5Dcreate2(group, name, file_type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+      H5Dclose, std::string("create dataset ") + name
+  };
+
+  if (rows > 0) {
+    check(H5Dwrite(dataset, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data),
+          std::string("write dataset ") + name);
+  }
+
+}
+
+/**
+ * Read a whole dataset in to a buffer of `n_values` values.
+ */
+void
+read_dataset(hid_t file, const char *name, hid_t mem_type, hsize_t n_values, void *data) {
+
+  Handle dataset{H5Dopen2(file, name, H5P_DEFAULT), H5Dclose, std::string("open dataset ") + name};
+  Handle space{H5Dget_space(dataset), H5Sclose, std::string("get dataspace of ") + name};
+
+  hssize_t n_points = H5Sget_simple_extent_npoints(space);
+  if (n_points < 0 || (hsize_t) n_points != n_values) {
+    throw ModelHdf5Exception(std::string("Unexpected size of dataset ") + name);
+  }
+
+  if (n_values > 0) {
+    check(H5Dread(dataset, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data),
+          std::string("read dataset ") + name);
+  }
+
+}
+
+/**
+ * Retrieve the dimensions of a dataset.
+ */
+std::vector<hsize_t>
+dataset_dims(hid_t file, const char *name) {
+
+  Handle dataset{H5Dopen2(file, name, H5P_DEFAULT), H5Dclose, std::string("open dataset ") + name};
+  Handle space{H5Dget_space(dataset), H5Sclose, std::string("get dataspace of ") + name};
+
+  int rank = H5Sget_simple_extent_ndims(space);
+  if (rank < 0) throw ModelHdf5Exception(std::string("HDF5 error: get rank of ") + name);
+
+  std::vector<hsize_t> dims(rank);
+  H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+
+  return dims;
+
+}
+
+/**
+ * Read the zone titles from the /fields/titles dataset.
+ */
+std::vector<std::string>
+read_titles(hid_t file, size_t n_zones) {
+
+  std::vector<std::string> titles(n_zones);
+
+  Handle source{H5Dopen2(file, "/fields/titles", H5P_DEFAULT), H5Dclose, "open titles"};
+  Handle space{H5Dget_space(source), H5Sclose, "get dataspace of titles"};
+  Handle type = string_type();
+
+  hssize_t n_points = H5Sget_simple_extent_npoints(space);
+  if (n_points < 0 || (size_t) n_points != n_zones) {
+    throw ModelHdf5Exception("Unexpected number of zone titles.");
+  }
+
+  std::vector<char *> c_titles(n_zones, nullptr);
+  if (n_zones > 0) {
+    check(H5Dread(source, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, c_titles.data()), "read titles");
+    for (size_t i = 0; i < n_zones; ++i) {
+      if (c_titles[i] != nullptr) titles[i] = c_titles[i];
+    }
+#if H5_VERSION_GE(1, 12, 0)
+    H5Treclaim(type, space, H5P_DEFAULT, c_titles.data());
+#else
+    H5Dvlen_reclaim(type, space, H5P_DEFAULT, c_titles.data());
+#endif
+  }
+
+  return titles;
+
+}
+
+/**
+ * Read zones [first, first + count) of the field dataset.
+ */
+std::vector<fv_list>
+read_zone_vectors(hid_t dataset, hsize_t n_zones, hsize_t n_verts, hsize_t first, hsize_t count) {
+
+  if (first + count > n_zones) {
+    throw ModelHdf5Exception("Zone range is out of bounds.");
+  }
+
+  std::vector<fv_list> zones(count, fv_list(n_verts));
+  if (count == 0 || n_verts == 0) return zones;
+
+  Handle file_space{H5Dget_space(dataset), H5Sclose, "get field dataspace"};
+
+  std::array<hsize_t, 3> mem_dims{1, n_verts, 3};
+  Handle mem_space{H5Screate_simple(3, mem_dims.data(), nullptr), H5Sclose, "create memory dataspace"};
+
+  for (hsize_t i = 0; i < count; ++i) {
+
+    std::array<hsize_t, 3> start{first + i, 0, 0};
+    std::array<hsize_t, 3> block{1, n_verts, 3};
+
+    check(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start.data(), nullptr, block.data(), nullptr),
+          "select zone");
+    check(H5Dread(dataset, native_field_type(), mem_space, file_space, H5P_DEFAULT, zones[i].data()),
+          "read zone");
+
+  }
+
+  return zones;
+
+}
+
+/**
+ * Field source that reads one zone hyperslab from an open HDF5 file.
+ */
+class Hdf5FieldSource : public FieldSource {
+
+ public:
+
+  explicit Hdf5FieldSource(const std::string &file_name) :
+      _file{H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose, "open " + file_name},
+      _dataset{H5Dopen2(_file, "/fields/m", H5P_DEFAULT), H5Dclose, "open dataset /fields/m"} {
+
+    Handle space{H5Dget_space(_dataset), H5Sclose, "get field dataspace"};
+
+    std::array<hsize_t, 3> dims{};
+    if (H5Sget_simple_extent_ndims(space) != 3) {
+      throw ModelHdf5Exception("The field dataset must have three dimensions.");
+    }
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+
+    _n_zones = dims[0];
+    _n_verts = dims[1];
+
+    _titles = read_titles(_file, _n_zones);
+
+  }
+
+  [[nodiscard]] size_t
+  n_fields() const override { return _n_zones; }
+
+  [[nodiscard]] size_t
+  n_verts() const { return _n_verts; }
+
+  [[nodiscard]] Field
+  load(size_t index) const override {
+
+    std::lock_guard<std::recursive_mutex> lock{hdf5_mutex};
+
+    auto zones = read_zone_vectors(_dataset, _n_zones, _n_verts, index, 1);
+
+    return Field{_titles[index], std::move(zones.front())};
+
+  }
+
+ private:
+
+  Handle _file;
+
+  Handle _dataset;
+
+  hsize_t _n_zones;
+
+  hsize_t _n_verts;
+
+  std::vector<std::string> _titles;
+
+};
+
+}
+
+void
+ModelHdf5::write(const Model &model, const std::string &file_name, int compression_level) {
+
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex};
+
+  const auto &mesh = model.mesh();
+  const auto &field_list = model.field_list();
+
+  auto n_verts = (hsize_t) mesh.vcl().size();
+  auto n_elems = (hsize_t) mesh.til().size();
+  auto n_zones = (hsize_t) field_list.n_fields();
+
+  static_assert(sizeof(size_t) == sizeof(uint64_t),
+                "Mesh indices are written as raw 64-bit values.");
+
+  Handle file{H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT), H5Fclose,
+              "create " + file_name};
+
+  // Format version.
+  {
+    Handle space{H5Screate(H5S_SCALAR), H5Sclose, "create scalar dataspace"};
+    Handle attribute{
+        H5Acreate2(file, "format_version", H5T_STD_I32LE, space, H5P_DEFAULT, H5P_DEFAULT),
+        H5Aclose, "create format_version"
+    };
+    int version = format_version;
+    check(H5Awrite(attribute, H5T_NATIVE_INT, &version), "write format_version");
+  }
+
+  // Mesh.
+  {
+    Handle group{H5Gcreate2(file, "/mesh", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                 "create group /mesh"};
+
+    write_dataset(group, "vertices", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, n_verts, 3,
+                  mesh.vcl().data());
+    bool narrow = mesh.til().index_size() == sizeof(uint32_t);
+    write_dataset(group, "tets", narrow ? H5T_STD_U32LE : H5T_STD_U64LE,
+                  narrow ? H5T_NATIVE_UINT32 : H5T_NATIVE_UINT64, n_elems, 4, mesh.til().data());
+    write_dataset(group, "submesh", H5T_STD_U64LE, H5T_NATIVE_UINT64, n_elems, 0,
+                  mesh.sml().data());
+
+    if (mesh.is_reordered()) {
+      write_dataset(group, "vertex_order", H5T_STD_U64LE, H5T_NATIVE_UINT64,
+                    mesh.vertex_order().size(), 0, mesh.vertex_order().data());
+      write_dataset(group, "tet_order", H5T_STD_U64LE, H5T_NATIVE_UINT64,
+                    mesh.tet_order().size(), 0, mesh.tet_order().data());
+    }
+  }
+
+  // Fields.
+  {
+    Handle group{H5Gcreate2(file, "/fields", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                 "create group /fields"};
+
+    std::array<hsize_t, 3> dims{n_zones, n_verts, 3};
+    Handle space{H5Screate_simple(3, dims.data(), nullptr), H5Sclose, "create field dataspace"};
+
+    Handle properties{H5Pcreate(H5P_DATASET_CREATE), H5Pclose, "create dataset properties"};
+    if (n_zones > 0 && n_verts > 0) {
+      // One chunk row per zone, limited to roughly 1.5MB per chunk.
+      std::array<hsize_t, 3> chunk{1, std::min<hsize_t>(n_verts, 65536), 3};
+      check(H5Pset_chunk(properties, 3, chunk.data()), "set chunk size");
+      if (compression_level > 0) {
+        check(H5Pset_shuffle(properties), "set shuffle filter");
+        check(H5Pset_deflate(properties, std::min(compression_level, 9)), "set deflate filter");
+      }
+    }
+
+    Handle dataset{
+        H5Dcreate2(group, "m", std::is_same_v<field_scalar, float> ? H5T_IEEE_F32LE : H5T_IEEE_F64LE,
+                   space, H5P_DEFAULT, properties, H5P_DEFAULT),
+        H5Dclose, "create dataset /fields/m"
+    };
+
+    std::array<hsize_t, 3> mem_dims{1, n_verts, 3};
+    Handle mem_space{H5Screate_simple(3, mem_dims.data(), nullptr), H5Sclose, "create memory dataspace"};
+
+    std::vector<std::string> titles;
+    titles.reserve(n_zones);
+
+    fv_list scratch;
+
+    for (hsize_t i = 0; i < n_zones; ++i) {
+
+      auto field = field_list.field(i);
+      if (field->size() != n_verts) {
+        throw ModelHdf5Exception("Field size does not match the number of vertices.");
+      }
+      titles.push_back(field->annotation());
+
+      if (n_verts == 0) continue;
+
+      std::array<hsize_t, 3> start{i, 0, 0};
+      std::array<hsize_t, 3> block{1, n_verts, 3};
+      check(H5Sselect_hyperslab(space, H5S_SELECT_SET, start.data(), nullptr, block.data(), nullptr),
+            "select zone");
+      check(H5Dwrite(dataset, native_field_type(), mem_space, space, H5P_DEFAULT,
+                     field->interleaved(scratch).data()),
+            "write zone");
+
+    }
+
+    // Zone titles, in a dataset of their own since attributes are limited to
+    // 64KB, which is only a few thousand titles.
+    std::vector<const char *> c_titles;
+    c_titles.reserve(titles.size());
+    for (const auto &title : titles) c_titles.push_back(title.c_str());
+
+    std::array<hsize_t, 1> title_dims{n_zones};
+    Handle title_space{H5Screate_simple(1, title_dims.data(), nullptr), H5Sclose, "create titles dataspace"};
+    Handle type = string_type();
+    Handle title_dataset{
+        H5Dcreate2(group, "titles", type, title_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+        H5Dclose, "create dataset /fields/titles"
+    };
+    if (n_zones > 0) {
+      check(H5Dwrite(title_dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, c_titles.data()),
+            "write titles");
+    }
+  }
+
+}
+
+Model
+ModelHdf5::read(const std::string &file_name, size_t max_resident) {
+
+  std::shared_ptr<Hdf5FieldSource> source;
+
+  v_list vcl;
+  Connectivity til;
+  sm_list sml;
+  MeshOrder order;
+
+  {
+    std::lock_guard<std::recursive_mutex> lock{hdf5_mutex};
+
+    Handle file{H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose, "open " + file_name};
+
+    auto vert_dims = dataset_dims(file, "/mesh/vertices");
+    auto tet_dims = dataset_dims(file, "/mesh/tets");
+    if (vert_dims.size() != 2 || vert_dims[1] != 3 || tet_dims.size() != 2 || tet_dims[1] != 4) {
+      throw ModelHdf5Exception("Unexpected shape of the mesh datasets.");
+    }
+
+    vcl.resize(vert_dims[0]);
+    til = Connectivity::for_vertices(vert_dims[0], tet_dims[0]);
+    sml.resize(tet_dims[0]);
+
+    read_dataset(file, "/mesh/vertices", H5T_NATIVE_DOUBLE, 3 * vcl.size(), vcl.data());
+    // HDF5 converts between the stored and the in-memory index width.
+    read_dataset(file, "/mesh/tets",
+                 til.index_size() == sizeof(uint32_t) ? H5T_NATIVE_UINT32 : H5T_NATIVE_UINT64,
+                 4 * til.size(), til.data());
+    read_dataset(file, "/mesh/submesh", H5T_NATIVE_UINT64, sml.size(), sml.data());
+
+    // Only written for meshes that have been renumbered.
+    if (H5Lexists(file, "/mesh/vertex_order", H5P_DEFAULT) > 0) {
+      order.vertex_order.resize(vcl.size());
+      order.tet_order.resize(til.size());
+      read_dataset(file, "/mesh/vertex_order", H5T_NATIVE_UINT64, order.vertex_order.size(),
+                   order.vertex_order.data());
+      read_dataset(file, "/mesh/tet_order", H5T_NATIVE_UINT64, order.tet_order.size(),
+                   order.tet_order.data());
+    }
+
+    source = std::make_shared<Hdf5FieldSource>(file_name);
+  }
+
+  if (source->n_fields() > 0 && source->n_verts() != vcl.size()) {
+    throw ModelHdf5Exception("Field size does not match the number of vertices.");
+  }
+
+  return {Mesh{std::move(vcl), std::move(til), std::move(sml), std::move(order)},
+          FieldList{source, max_resident}};
+
+}
+
+std::vector<Field>
+ModelHdf5::read_zones(const std::string &file_name, size_t first, size_t count) {
+
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex};
+
+  Handle file{H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose, "open " + file_name};
+  Handle dataset{H5Dopen2(file, "/fields/m", H5P_DEFAULT), H5Dclose, "open dataset /fields/m"};
+
+  auto dims = dataset_dims(file, "/fields/m");
+  if (dims.size() != 3) {
+    throw ModelHdf5Exception("The field dataset must have three dimensions.");
+  }
+
+  auto titles = read_titles(file, dims[0]);
+  auto zones = read_zone_vectors(dataset, dims[0], dims[1], first, count);
+
+  std::vector<Field> fields;
+  fields.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    fields.emplace_back(titles[first + i], std::move(zones[i]));
+  }
+
+  return fields;
+
+}
+
+size_t
+ModelHdf5::n_zones(const std::string &file_name) {
+
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex};
+
+  Handle file{H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose, "open " + file_name};
+
+  auto dims = dataset_dims(file, "/fields/m");
+  if (dims.empty()) {
+    throw ModelHdf5Exception("The field dataset must have three dimensions.");
+  }
+
+  return dims[0];
+
+}
+
+void
+ModelHdf5::convert_tecplot(const std::string &tecplot_file_name,
+                           const std::string &file_name,
+                           int compression_level,
+                           std::optional<Ordering> ordering) {
+
+  // Zones of ASCII files are streamed through the lazy field list one at a
+  // time, so the conversion never holds more than a few zones in memory.
+  // Binary files are read in one go.
+  Model model = tecplot_file_name.ends_with(".plt") || tecplot_file_name.ends_with(".szplt")
+                ? TecplotBinaryFileLoader::read(tecplot_file_name)
+                : TecplotFileLoader::read_lazy(tecplot_file_name, 2);
+
+  if (ordering) model.reorder(*ordering);
+
+  write(model, file_name, compression_level);
+
+}
@@ -0,0 +1,129 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_MODEL_HDF5_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_MODEL_HDF5_HPP_
+
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "field.hpp"
+#include "model.hpp"
+
+/**
+ * Object that will be thrown when reading or writing an HDF5 model fails.
+ */
+class ModelHdf5Exception : public std::exception {
+
+ public:
+
+  /**
+   * Constructor, will create a new exception object.
+   * @param message the exception message.
+   */
+  explicit
+  ModelHdf5Exception(std::string message) :
+      _message(std::move(message)) {}
+
+  [[nodiscard]] const char *
+  what() const noexcept override {
+
+    return _message.c_str();
+
+  }
+
+ private:
+
+  std::string _message;
+
+};
+
+/**
+ * Reads and writes models in the native HDF5 format. A file holds
+ *   - /mesh/vertices  [n_verts][3] double, vertex coordinates,
+ *   - /mesh/tets      [n_elems][4] uint32 or uint64, 0-based tetrahedra,
+ *   - /mesh/submesh   [n_elems]    uint64, sub-mesh index of each tetrahedron,
+ *   - /mesh/vertex_order, /mesh/tet_order
+ *                     [n_verts], [n_elems] uint64, the original index of
+ *                     each vertex and tetrahedron, only present if the mesh
+ *                     has been renumbered (see Model::reorder()),
+ *   - /fields/m       [n_zones][n_verts][3] double (float when built with
+ *                     MMPPT_SINGLE_PRECISION_FIELDS), one zone per chunk
+ *                     row, optionally deflate compressed,
+ *   - /fields/titles  [n_zones] variable length UTF-8 string, zone titles.
+ * Fields are converted to the precision of the build when they are read, so
+ * files of either precision can be read by either build.
+ * The field dataset is chunked per zone so that single zones or ranges of
+ * zones can be read without touching the rest of the file.
+ */
+class ModelHdf5 {
+
+ public:
+
+  /**
+   * The version of the layout written by this class, stored in the
+   * 'format_version' attribute of the root group.
+   */
+  static constexpr int format_version = 1;
+
+  /**
+   * Write a model.
+   * @param model the model.
+   * @param file_name the name of the HDF5 file, an existing file is replaced.
+   * @param compression_level deflate level from 1 to 9, 0 disables
+   *                          compression.
+   */
+  static void
+  write(const Model &model, const std::string &file_name, int compression_level = 4);
+
+  /**
+   * Read a model, only the mesh is read up front, zones are read one
+   * hyperslab at a time when they are first asked for.
+   * @param file_name the name of the HDF5 file.
+   * @param max_resident the maximum number of decoded zones kept in memory.
+   * @return the model.
+   */
+  static Model
+  read(const std::string &file_name,
+       size_t max_resident = FieldList::default_max_resident);
+
+  /**
+   * Read a contiguous range of zones.
+   * @param file_name the name of the HDF5 file.
+   * @param first the index of the first zone.
+   * @param count the number of zones.
+   * @return the fields of the zones.
+   */
+  static std::vector<Field>
+  read_zones(const std::string &file_name, size_t first, size_t count);
+
+  /**
+   * Retrieve the number of zones in a file without reading any of them.
+   * @param file_name the name of the HDF5 file.
+   * @return the number of zones.
+   */
+  static size_t
+  n_zones(const std::string &file_name);
+
+  /**
+   * Convert a tecplot file to the HDF5 format.
+   * @param tecplot_file_name the name of the tecplot file, ASCII ('*.tec')
+   *                          or binary ('*.plt').
+   * @param file_name the name of the HDF5 file.
+   * @param compression_level deflate level from 1 to 9, 0 disables
+   *                          compression.
+   * @param ordering optionally, renumber the mesh before it is written.
+   */
+  static void
+  convert_tecplot(const std::string &tecplot_file_name,
+                  const std::string &file_name,
+                  int compression_level = 4,
+                  std::optional<Ordering> ordering = std::nullopt);
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_MODEL_HDF5_HPP_
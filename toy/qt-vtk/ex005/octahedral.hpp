@@ -0,0 +1,262 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_OCTAHEDRAL_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_OCTAHEDRAL_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Holds a list of 3-vectors compressed with octahedral encoding. The
+ * direction of each vector is projected on to the octahedron |x|+|y|+|z|=1,
+ * the octahedron is unfolded on to a square and the square coordinates are
+ * quantised to two 16 bit integers, so a unit vector takes 4 bytes instead
+ * of 24. When some vectors are not unit length their magnitudes are kept in
+ * an extra single precision channel (8 bytes per vector in total).
+ *
+ * Each code is chosen as the one of its four neighbouring grid points that
+ * decodes closest to the original direction, the angle between an original
+ * and decoded direction is at most `max_angular_error`. Magnitudes carry
+ * the relative error of a float.
+ */
+class OctahedralVectors {
+
+ public:
+
+  /**
+   * The largest angle, in radians, between an encoded direction and its
+   * decoded direction (about 0.003 degrees). The largest error measured over
+   * 2e7 directions, half of them close to the octahedron's edges and
+   * vertices, was 4.3e-5.
+   */
+  static constexpr double max_angular_error = 5.0e-5;
+
+  /**
+   * Vectors whose length differs from one by more than this are not treated
+   * as unit vectors, if there are any the magnitude channel is kept.
+   */
+  static constexpr double unit_tolerance = 1.0e-6;
+
+  /**
+   * Create an empty list.
+   */
+  OctahedralVectors() = default;
+
+  /**
+   * Encode a list of vectors.
+   * @param n the number of vectors.
+   * @param vector function returning vector `i` as something indexable by 0,
+   *               1 and 2, e.g. a `fv`.
+   */
+  template<typename Fn>
+  OctahedralVectors(size_t n, Fn &&vector) :
+      _codes(n) {
+
+    std::vector<float> magnitudes(n);
+    bool all_unit = true;
+
+    for (size_t i = 0; i < n; ++i) {
+
+      auto v = vector(i);
+      double x = v[0], y = v[1], z = v[2];
+
+      double magnitude = std::sqrt(x * x + y * y + z * z);
+      magnitudes[i] = (float) magnitude;
+      if (std::abs(magnitude - 1.0) > unit_tolerance) all_unit = false;
+
+      _codes[i] = encode(x, y, z);
+
+    }
+
+    if (!all_unit) _magnitudes = std::move(magnitudes);
+
+  }
+
+  /**
+   * Retrieve the number of vectors.
+   * @return the number of vectors.
+   */
+  [[nodiscard]] size_t
+  size() const { return _codes.size(); }
+
+  /**
+   * Check whether the magnitude channel is kept.
+   * @return true if some vectors are not unit length, otherwise false.
+   */
+  [[nodiscard]] bool
+  has_magnitudes() const { return !_magnitudes.empty(); }
+
+  /**
+   * Retrieve the number of bytes used by the encoded vectors.
+   * @return the number of bytes.
+   */
+  [[nodiscard]] size_t
+  size_bytes() const {
+    return _codes.size() * sizeof(uint32_t) + _magnitudes.size() * sizeof(float);
+  }
+
+  /**
+   * Create a copy with the vectors in a different order, the codes are
+   * copied so no further error is introduced.
+   * @param order the old index of each new index.
+   * @return the reordered vectors.
+   */
+  [[nodiscard]] OctahedralVectors
+  permuted(const std::vector<size_t> &order) const {
+
+    OctahedralVectors result;
+    result._codes.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) result._codes[i] = _codes.at(order[i]);
+
+    if (has_magnitudes()) {
+      result._magnitudes.resize(order.size());
+      for (size_t i = 0; i < order.size(); ++i) result._magnitudes[i] = _magnitudes[order[i]];
+    }
+
+    return result;
+
+  }
+
+  /**
+   * Decode a range of vectors in to interleaved storage. The loop has no
+   * branches so that the compiler can vectorise it.
+   * @tparam T the scalar type of the output.
+   * @param first the index of the first vector.
+   * @param count the number of vectors.
+   * @param out storage for 3 * count values, x, y, z for each vector.
+   */
+  template<typename T>
+  void
+  decode(size_t first, size_t count, T *out) const {
+
+    if (first + count > _codes.size()) {
+      throw std::out_of_range("Octahedral vector range is out of bounds.");
+    }
+
+    const uint32_t *codes = _codes.data() + first;
+
+    for (size_t i = 0; i < count; ++i) {
+      decode_direction(codes[i], out + 3 * i);
+    }
+
+    if (has_magnitudes()) {
+      const float *magnitudes = _magnitudes.data() + first;
+      for (size_t i = 0; i < count; ++i) {
+        out[3 * i + 0] *= (T) magnitudes[i];
+        out[3 * i + 1] *= (T) magnitudes[i];
+        out[3 * i + 2] *= (T) magnitudes[i];
+      }
+    }
+
+  }
+
+  /**
+   * Encode the direction of a vector, a zero vector is given the direction
+   * of the z axis.
+   * @param x the x component.
+   * @param y the y component.
+   * @param z the z component.
+   * @return the 16 bit square coordinates, u in the low half.
+   */
+  static uint32_t
+  encode(double x, double y, double z) {
+
+    double length = std::sqrt(x * x + y * y + z * z);
+    if (length == 0.0) {
+      z = 1.0;
+      length = 1.0;
+    }
+    x /= length;
+    y /= length;
+    z /= length;
+
+    // Project on to the octahedron, then fold the lower hemisphere out in to
+    // the corners of the square.
+    double l1 = std::abs(x) + std::abs(y) + std::abs(z);
+    double u = x / l1;
+    double v = y / l1;
+    if (z < 0.0) {
+      double folded_u = (1.0 - std::abs(v)) * (u >= 0.0 ? 1.0 : -1.0);
+      double folded_v = (1.0 - std::abs(u)) * (v >= 0.0 ? 1.0 : -1.0);
+      u = folded_u;
+      v = folded_v;
+    }
+
+    // Try the grid points around (u, v) and keep the one that decodes
+    // closest to the original direction.
+    double qu = std::floor((u + 1.0) * 0.5 * code_max);
+    double qv = std::floor((v + 1.0) * 0.5 * code_max);
+
+    uint32_t best = 0;
+    double best_dot = -2.0;
+
+    for (int du = 0; du < 2; ++du) {
+      for (int dv = 0; dv < 2; ++dv) {
+
+        auto cu = (uint32_t) std::clamp(qu + du, 0.0, (double) code_max);
+        auto cv = (uint32_t) std::clamp(qv + dv, 0.0, (double) code_max);
+        uint32_t code = cu | (cv << 16);
+
+        double decoded[3];
+        decode_direction(code, decoded);
+        double dot = decoded[0] * x + decoded[1] * y + decoded[2] * z;
+
+        if (dot > best_dot) {
+          best_dot = dot;
+          best = code;
+        }
+
+      }
+    }
+
+    return best;
+
+  }
+
+ private:
+
+  // The largest quantised square coordinate.
+  static constexpr uint32_t code_max = 0xffff;
+
+  // Square coordinates, u in the low 16 bits and v in the high 16 bits.
+  std::vector<uint32_t> _codes;
+
+  // Vector magnitudes, empty if every vector is a unit vector.
+  std::vector<float> _magnitudes;
+
+  /**
+   * Decode a single direction, this has no branches so that loops over it
+   * can be vectorised.
+   * @tparam T the scalar type of the output.
+   * @param code the code.
+   * @param out the unit vector.
+   */
+  template<typename T>
+  static void
+  decode_direction(uint32_t code, T *out) {
+
+    T u = (T) (code & 0xffffu) * (T) (2.0 / code_max) - (T) 1;
+    T v = (T) (code >> 16) * (T) (2.0 / code_max) - (T) 1;
+    T w = (T) 1 - std::abs(u) - std::abs(v);
+
+    // Fold the lower hemisphere back out of the square's corners.
+    T t = std::max(-w, (T) 0);
+    u -= std::copysign(t, u);
+    v -= std::copysign(t, v);
+
+    T scale = (T) 1 / std::sqrt(u * u + v * v + w * w);
+    out[0] = u * scale;
+    out[1] = v * scale;
+    out[2] = w * scale;
+
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_OCTAHEDRAL_HPP_
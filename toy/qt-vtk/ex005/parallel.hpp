@@ -0,0 +1,341 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_PARALLEL_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Retrieve the number of worker threads to use.
+ * @param n_threads the requested number of threads, zero means one per core.
+ * @return the number of threads to use, this is always at least one.
+ */
+inline size_t
+thread_count(size_t n_threads = 0) {
+
+  if (n_threads == 0) {
+    n_threads = std::thread::hardware_concurrency();
+  }
+
+  return std::max<size_t>(n_threads, 1);
+
+}
+
+/**
+ * A fixed set of worker threads that runs the work of parallel_for(). The
+ * threads are started by the first parallel call and live until the program
+ * exits, so parallel calls do not pay for starting threads, and the number
+ * of threads doing parallel work never exceeds the workers plus the threads
+ * that made the calls, however the calls are nested.
+ */
+class ThreadPool {
+
+ public:
+
+  /**
+   * Retrieve the pool shared by every parallel call, it has one thread less
+   * than there are cores since the calling thread works too.
+   * @return the pool.
+   */
+  static ThreadPool &
+  instance() {
+    static ThreadPool pool{thread_count() - 1};
+    return pool;
+  }
+
+  /**
+   * Start a pool.
+   * @param n_workers the number of worker threads.
+   */
+  explicit ThreadPool(size_t n_workers) {
+    _workers.reserve(n_workers);
+    for (size_t t = 0; t < n_workers; ++t) {
+      _workers.emplace_back([this]() { run(); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+
+  ThreadPool &
+  operator=(const ThreadPool &) = delete;
+
+  /**
+   * Stop the workers, tasks that have not been started are dropped.
+   */
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto &worker : _workers) worker.join();
+  }
+
+  /**
+   * Retrieve the number of worker threads.
+   * @return the number of workers.
+   */
+  [[nodiscard]] size_t
+  size() const { return _workers.size(); }
+
+  /**
+   * Queue a task for the workers, the task must not throw.
+   * @param task the task.
+   */
+  void
+  submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      _tasks.push_back(std::move(task));
+    }
+    _wake.notify_one();
+  }
+
+ private:
+
+  void
+  run() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _wake.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+        if (_stopping) return;
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> _workers;
+
+  std::mutex _mutex;
+
+  std::condition_variable _wake;
+
+  std::deque<std::function<void()>> _tasks;
+
+  bool _stopping{false};
+
+};
+
+/**
+ * Call `fn(i)` for every `i` in [0, n) on a bounded set of worker threads.
+ * Work items are handed out dynamically, so items of different cost are
+ * balanced between threads. The calling thread works on items too, helped
+ * by up to `n_threads - 1` threads of the shared ThreadPool. A helper that
+ * only gets to run once every item has been taken does nothing, so the call
+ * never waits for the pool to become free and calls may be nested (a nested
+ * call gets whichever workers are idle). If any call throws, the exception
+ * of the item with the lowest index is rethrown once all workers are
+ * finished, this makes the reported error independent of the number of
+ * threads.
+ * @param n the number of work items.
+ * @param fn the function to call for each item.
+ * @param n_threads the maximum number of threads, zero means one per core.
+ */
+template<typename Fn>
+void
+parallel_for(size_t n, Fn &&fn, size_t n_threads = 0) {
+
+  n_threads = std::min(thread_count(n_threads), n);
+
+  ThreadPool *pool = nullptr;
+  if (n_threads > 1) {
+    pool = &ThreadPool::instance();
+    n_threads = std::min(n_threads, pool->size() + 1);
+  }
+
+  if (n_threads <= 1) {
+    for (size_t i = 0; i < n; ++i) fn(i);
+    return;
+  }
+
+  // Helpers that have not started by the time the items run out see that
+  // the call is closed and return without touching the items, the call
+  // only waits for the helpers that did start.
+  struct State {
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t active{0};
+    bool closed{false};
+  };
+
+  auto state = std::make_shared<State>();
+  std::vector<std::exception_ptr> errors(n);
+
+  auto worker = [&]() {
+    for (size_t i = state->next++; i < n; i = state->next++) {
+      try {
+        fn(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  for (size_t t = 0; t < n_threads - 1; ++t) {
+    pool->submit([state, &worker]() {
+      {
+        std::lock_guard<std::mutex> lock{state->mutex};
+        if (state->closed) return;
+        ++state->active;
+      }
+      worker();
+      std::lock_guard<std::mutex> lock{state->mutex};
+      if (--state->active == 0) state->finished.notify_all();
+    });
+  }
+
+  worker();
+
+  {
+    std::unique_lock<std::mutex> lock{state->mutex};
+    state->closed = true;
+    state->finished.wait(lock, [&state]() { return state->active == 0; });
+  }
+
+  for (const auto &error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+
+}
+
+/**
+ * Call `fn(begin, end)` for contiguous blocks that cover [0, n) on a bounded
+ * set of worker threads. Blocks are at least `grain` items long.
+ * @param n the number of items.
+ * @param grain the minimum number of items per block.
+ * @param fn the function to call for each block.
+ * @param n_threads the maximum number of threads, zero means one per core.
+ */
+template<typename Fn>
+void
+parallel_for_blocks(size_t n, size_t grain, Fn &&fn, size_t n_threads = 0) {
+
+  if (n == 0) return;
+
+  grain = std::max<size_t>(grain, 1);
+
+  size_t n_blocks = std::min(4 * thread_count(n_threads), (n + grain - 1) / grain);
+  size_t block_size = (n + n_blocks - 1) / n_blocks;
+  n_blocks = (n + block_size - 1) / block_size;
+
+  parallel_for(n_blocks, [&](size_t b) {
+    size_t begin = b * block_size;
+    fn(begin, std::min(begin + block_size, n));
+  }, n_threads);
+
+}
+
+/**
+ * Sort records by an unsigned integer key with a parallel least significant
+ * digit radix sort. The sort is stable, and the result does not depend on
+ * the number of threads. Each pass histograms one digit per block of
+ * records, turns the histograms in to per block output positions and
+ * scatters the blocks concurrently. Passes whose digit is the same for every
+ * record are skipped.
+ * @tparam Record a trivially copyable record type.
+ * @param records the records to sort.
+ * @param n_bits the number of significant key bits, keys must be less than
+ *               2^n_bits.
+ * @param key_bits function returning the key of a record shifted right by a
+ *                 given number of bits, `key_bits(record, shift)`, at least
+ *                 the low 16 bits of the result must be valid.
+ * @param n_threads the maximum number of threads, zero means one per core.
+ */
+template<typename Record, typename KeyBits>
+void
+parallel_radix_sort(std::vector<Record> &records, size_t n_bits, KeyBits &&key_bits,
+                    size_t n_threads = 0) {
+
+  static_assert(std::is_trivially_copyable_v<Record>, "Radix sorted records must be trivially copyable.");
+
+  // Digits of up to 11 bits keep the per block histograms and the scatter
+  // destinations in cache.
+  constexpr size_t max_digit_bits = 11;
+  constexpr size_t min_block_size = 1 << 16;
+
+  size_t n = records.size();
+  if (n < 2 || n_bits == 0) return;
+
+  size_t n_passes = (n_bits + max_digit_bits - 1) / max_digit_bits;
+  size_t digit_bits = (n_bits + n_passes - 1) / n_passes;
+  size_t n_buckets = size_t{1} << digit_bits;
+  uint64_t mask = n_buckets - 1;
+
+  size_t n_blocks = std::min(thread_count(n_threads), (n + min_block_size - 1) / min_block_size);
+  size_t block_size = (n + n_blocks - 1) / n_blocks;
+  n_blocks = (n + block_size - 1) / block_size;
+
+  auto scratch = std::make_unique_for_overwrite<Record[]>(n);
+  Record *src = records.data();
+  Record *dst = scratch.get();
+
+  // Bucket counts, then output positions, indexed by [block][bucket].
+  std::vector<size_t> counts(n_blocks * n_buckets);
+
+  for (size_t pass = 0; pass < n_passes; ++pass) {
+
+    auto shift = (unsigned) (pass * digit_bits);
+
+    parallel_for(n_blocks, [&](size_t b) {
+      size_t *count = counts.data() + b * n_buckets;
+      std::fill(count, count + n_buckets, 0);
+      for (size_t i = b * block_size, end = std::min(i + block_size, n); i < end; ++i) {
+        ++count[key_bits(src[i], shift) & mask];
+      }
+    }, n_threads);
+
+    // Output positions, bucket by bucket and, within a bucket, block by
+    // block, which keeps the sort stable.
+    size_t position = 0;
+    bool constant = false;
+    for (size_t bucket = 0; bucket < n_buckets; ++bucket) {
+      size_t start = position;
+      for (size_t b = 0; b < n_blocks; ++b) {
+        size_t count = counts[b * n_buckets + bucket];
+        counts[b * n_buckets + bucket] = position;
+        position += count;
+      }
+      if (position - start == n) constant = true;
+    }
+    if (constant) continue;
+
+    parallel_for(n_blocks, [&](size_t b) {
+      size_t *offset = counts.data() + b * n_buckets;
+      for (size_t i = b * block_size, end = std::min(i + block_size, n); i < end; ++i) {
+        dst[offset[key_bits(src[i], shift) & mask]++] = src[i];
+      }
+    }, n_threads);
+
+    std::swap(src, dst);
+
+  }
+
+  if (src != records.data()) {
+    parallel_for_blocks(n, min_block_size, [&](size_t begin, size_t end) {
+      std::memcpy(records.data() + begin, src + begin, (end - begin) * sizeof(Record));
+    }, n_threads);
+  }
+
+}
+
+#endif // MMPPT_TOY_QT_VTK_EX005_PARALLEL_HPP_
@@ -0,0 +1,491 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_POINT_LOCATOR_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_POINT_LOCATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "aliases.hpp"
+#include "parallel.hpp"
+
+/**
+ * Finds the tetrahedron that contains a point, and the point's barycentric
+ * coordinates in it, with a bounding volume hierarchy over the tetrahedra's
+ * bounding boxes.
+ *
+ * The hierarchy is built by median splits along the longest axis of the
+ * tetrahedra's centroids, down to leaves of at most `leaf_size`
+ * tetrahedra. With median splits the size of every subtree is known in
+ * advance, so subtrees are built in parallel straight in to their place in
+ * one flat node array, which is in depth first order: the first child of a
+ * node follows it and the second is further on. Nodes are 32 bytes, boxes
+ * are single precision and rounded outwards.
+ *
+ * The locator takes about 26 to 30 bytes per tetrahedron, nodes and the
+ * tetrahedron order together. It does not keep a copy of the mesh, queries
+ * are given the vertices and tetrahedra it was built from.
+ */
+class PointLocator {
+
+ public:
+
+  /**
+   * The largest number of tetrahedra in a leaf.
+   */
+  static constexpr size_t leaf_size = 4;
+
+  /**
+   * How far outside a tetrahedron, in barycentric coordinates, a point may
+   * be and still count as inside. This keeps points on shared faces and
+   * edges from falling between tetrahedra.
+   */
+  static constexpr double tolerance = 1.0e-10;
+
+  /**
+   * The result of a query.
+   */
+  struct Location {
+
+    // The index of the tetrahedron, no_tet if the point is outside the mesh.
+    size_t tet;
+
+    // Barycentric coordinates, weight i belongs to the tetrahedron's vertex i.
+    std::array<double, 4> weights;
+
+  };
+
+  /**
+   * Marks a point outside the mesh.
+   */
+  static constexpr size_t no_tet = std::numeric_limits<size_t>::max();
+
+  /**
+   * Create an empty locator, every point is outside.
+   */
+  PointLocator() = default;
+
+  /**
+   * Build a locator.
+   * @param vcl the (v)ertex (c)oordinate (l)ist.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  template<typename Index>
+  PointLocator(const v_list &vcl, const basic_tet_list<Index> &til, size_t n_threads = 0) {
+
+    if (til.size() >= std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("Too many tetrahedra for the point locator.");
+    }
+
+    size_t n = til.size();
+    if (n == 0) return;
+
+    // Tetrahedron bounding boxes, and the centroids that are partitioned.
+    std::vector<Box> boxes(n);
+    std::vector<Item> items(n);
+
+    parallel_for_blocks(n, grain, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; ++t) {
+        Box box = Box::empty();
+        for (size_t c = 0; c < 4; ++c) {
+          box.expand(vcl.at(til[t][c]));
+        }
+        boxes[t] = box;
+        for (int k = 0; k < 3; ++k) items[t].centroid[k] = 0.5f * (box.lo[k] + box.hi[k]);
+        items[t].tet = (uint32_t) t;
+      }
+    }, n_threads);
+
+    _nodes.resize(subtree_nodes(n));
+
+    // Build the top of the tree serially, until there are enough subtrees
+    // to keep every thread busy, then build the subtrees in parallel and
+    // finally fit the top nodes' boxes around their children.
+    std::vector<Task> tasks;
+    size_t task_size = std::max<size_t>(n / (8 * thread_count(n_threads)), 4096);
+    build(Task{0, 0, n}, items, boxes, task_size, &tasks);
+
+    parallel_for(tasks.size(), [&](size_t i) {
+      build(tasks[i], items, boxes, 0, nullptr);
+    }, n_threads);
+
+    fit(Task{0, 0, n}, task_size);
+
+    _tets.resize(n);
+    for (size_t i = 0; i < n; ++i) _tets[i] = items[i].tet;
+
+  }
+
+  /**
+   * Retrieve the number of tetrahedra.
+   * @return the number of tetrahedra.
+   */
+  [[nodiscard]] size_t
+  size() const { return _tets.size(); }
+
+  /**
+   * Retrieve the number of bytes used by the locator.
+   * @return the number of bytes.
+   */
+  [[nodiscard]] size_t
+  size_bytes() const {
+    return _nodes.size() * sizeof(Node) + _tets.size() * sizeof(uint32_t);
+  }
+
+  /**
+   * Find the tetrahedron that contains a point.
+   * @param vcl the (v)ertex (c)oordinate (l)ist the locator was built from.
+   * @param til the (t)etrahedra (i)ndex (l)ist the locator was built from.
+   * @param point the point.
+   * @return the tetrahedron and the point's barycentric coordinates, or
+   *         nothing if the point is outside the mesh.
+   */
+  template<typename Index>
+  [[nodiscard]] std::optional<Location>
+  locate(const v_list &vcl, const basic_tet_list<Index> &til, const vert &point) const {
+    Location location = find(vcl, til, point, no_tet);
+    if (location.tet == no_tet) return std::nullopt;
+    return location;
+  }
+
+  /**
+   * Find the tetrahedra that contain many points, in parallel. Each thread
+   * works through a contiguous range of points and tries the previous
+   * point's tetrahedron first, so coherent queries such as the samples of a
+   * plane mostly skip the tree.
+   * @param vcl the (v)ertex (c)oordinate (l)ist the locator was built from.
+   * @param til the (t)etrahedra (i)ndex (l)ist the locator was built from.
+   * @param points the points.
+   * @param locations the locations of the points, tet is no_tet for points
+   *                  outside the mesh. This must be as long as `points`.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  template<typename Index>
+  void
+  locate(const v_list &vcl, const basic_tet_list<Index> &til, std::span<const vert> points,
+         std::span<Location> locations, size_t n_threads = 0) const {
+
+    if (locations.size() != points.size()) {
+      throw std::invalid_argument("Need one location for every point.");
+    }
+
+    parallel_for_blocks(points.size(), grain, [&](size_t begin, size_t end) {
+      size_t hint = no_tet;
+      for (size_t i = begin; i < end; ++i) {
+        locations[i] = find(vcl, til, points[i], hint);
+        if (locations[i].tet != no_tet) hint = locations[i].tet;
+      }
+    }, n_threads);
+
+  }
+
+ private:
+
+  // Points handed to each thread at a time, and tetrahedra per block while
+  // building.
+  static constexpr size_t grain = 1 << 12;
+
+  // The deepest the tree can be with fewer than 2^32 tetrahedra.
+  static constexpr size_t max_depth = 64;
+
+  // An axis aligned box.
+  struct Box {
+
+    std::array<float, 3> lo;
+    std::array<float, 3> hi;
+
+    static Box
+    empty() {
+      constexpr float inf = std::numeric_limits<float>::infinity();
+      return {{inf, inf, inf}, {-inf, -inf, -inf}};
+    }
+
+    // Grow the box to hold a point, rounding outwards to single precision.
+    void
+    expand(const vert &v) {
+      for (int k = 0; k < 3; ++k) {
+        auto down = (float) v[k], up = (float) v[k];
+        if ((double) down > v[k]) down = std::nextafter(down, -std::numeric_limits<float>::infinity());
+        if ((double) up < v[k]) up = std::nextafter(up, std::numeric_limits<float>::infinity());
+        lo[k] = std::min(lo[k], down);
+        hi[k] = std::max(hi[k], up);
+      }
+    }
+
+    void
+    expand(const Box &box) {
+      for (int k = 0; k < 3; ++k) {
+        lo[k] = std::min(lo[k], box.lo[k]);
+        hi[k] = std::max(hi[k], box.hi[k]);
+      }
+    }
+
+    [[nodiscard]] bool
+    contains(const vert &v) const {
+      return v[0] >= lo[0] && v[0] <= hi[0]
+          && v[1] >= lo[1] && v[1] <= hi[1]
+          && v[2] >= lo[2] && v[2] <= hi[2];
+    }
+
+  };
+
+  // A node, a leaf holds `count` tetrahedra from _tets[index], an interior
+  // node has count zero and its second child at `index`.
+  struct Node {
+    Box box;
+    uint32_t index;
+    uint32_t count;
+  };
+
+  static_assert(sizeof(Node) == 32, "Point locator nodes should be 32 bytes.");
+
+  // A subtree to build, from node `node` over tetrahedra [begin, end).
+  struct Task {
+    size_t node;
+    size_t begin;
+    size_t end;
+  };
+
+  // A tetrahedron's centroid, while building.
+  struct Item {
+    std::array<float, 3> centroid;
+    uint32_t tet;
+  };
+
+  std::vector<Node> _nodes;
+
+  std::vector<uint32_t> _tets;
+
+  /**
+   * The number of nodes in a subtree over `n` tetrahedra. A median split
+   * gives halves of floor(n / 2) and ceil(n / 2) tetrahedra, so the nodes on
+   * each level of the tree have one of two adjacent sizes, `size` and
+   * `size + 1`, and the levels can be counted in one pass.
+   */
+  static size_t
+  subtree_nodes(size_t n) {
+
+    size_t size = n, n_small = 1, n_large = 0;
+    size_t nodes = 0;
+
+    while (n_small + n_large > 0) {
+
+      nodes += n_small + n_large;
+
+      // Split the nodes that are not leaves, their children are `next` or
+      // `next + 1` long.
+      size_t smallest = n_small > 0 && size > leaf_size ? size : size + 1;
+      size_t next = smallest / 2, next_small = 0, next_large = 0;
+
+      for (auto [m, count] : {std::pair{size, n_small}, std::pair{size + 1, n_large}}) {
+        if (m <= leaf_size) continue;
+        for (size_t child : {m / 2, m - m / 2}) {
+          (child == next ? next_small : next_large) += count;
+        }
+      }
+
+      size = next;
+      n_small = next_small;
+      n_large = next_large;
+
+    }
+
+    return nodes;
+
+  }
+
+  /**
+   * Build a subtree. If `tasks` is given, subtrees over no more than
+   * `task_size` tetrahedra are not built but added to `tasks`, and the boxes
+   * of the nodes above them are left for fit().
+   */
+  void
+  build(Task task, std::vector<Item> &items, const std::vector<Box> &boxes, size_t task_size,
+        std::vector<Task> *tasks) {
+
+    if (tasks != nullptr && task.end - task.begin <= task_size) {
+      tasks->push_back(task);
+      return;
+    }
+
+    Node &node = _nodes[task.node];
+    size_t n = task.end - task.begin;
+
+    if (n <= leaf_size) {
+      node.box = Box::empty();
+      for (size_t i = task.begin; i < task.end; ++i) node.box.expand(boxes[items[i].tet]);
+      node.index = (uint32_t) task.begin;
+      node.count = (uint32_t) n;
+      return;
+    }
+
+    Box centroid_box = Box::empty();
+    for (size_t i = task.begin; i < task.end; ++i) {
+      for (int k = 0; k < 3; ++k) {
+        centroid_box.lo[k] = std::min(centroid_box.lo[k], items[i].centroid[k]);
+        centroid_box.hi[k] = std::max(centroid_box.hi[k], items[i].centroid[k]);
+      }
+    }
+
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+      if (centroid_box.hi[k] - centroid_box.lo[k] > centroid_box.hi[axis] - centroid_box.lo[axis]) axis = k;
+    }
+
+    // Ties are broken by index so that the tree does not depend on the
+    // order nth_element happens to leave equal centroids in.
+    size_t middle = task.begin + n / 2;
+    std::nth_element(items.begin() + (std::ptrdiff_t) task.begin, items.begin() + (std::ptrdiff_t) middle,
+                     items.begin() + (std::ptrdiff_t) task.end,
+                     [axis](const Item &a, const Item &b) {
+                       return a.centroid[axis] < b.centroid[axis]
+                           || (a.centroid[axis] == b.centroid[axis] && a.tet < b.tet);
+                     });
+
+    size_t first = task.node + 1;
+    size_t second = first + subtree_nodes(n / 2);
+    node.index = (uint32_t) second;
+    node.count = 0;
+
+    build(Task{first, task.begin, middle}, items, boxes, task_size, tasks);
+    build(Task{second, middle, task.end}, items, boxes, task_size, tasks);
+
+    if (tasks == nullptr) {
+      node.box = _nodes[first].box;
+      node.box.expand(_nodes[second].box);
+    }
+
+  }
+
+  /**
+   * Fit the boxes of the nodes above the subtrees that were built in
+   * parallel.
+   */
+  void
+  fit(Task task, size_t task_size) {
+
+    if (task.end - task.begin <= task_size) return;
+
+    size_t middle = task.begin + (task.end - task.begin) / 2;
+    size_t first = task.node + 1;
+    size_t second = _nodes[task.node].index;
+
+    fit(Task{first, task.begin, middle}, task_size);
+    fit(Task{second, middle, task.end}, task_size);
+
+    _nodes[task.node].box = _nodes[first].box;
+    _nodes[task.node].box.expand(_nodes[second].box);
+
+  }
+
+  /**
+   * Compute the barycentric coordinates of a point in a tetrahedron.
+   * @return true if the point is inside, otherwise false.
+   */
+  template<typename Index>
+  static bool
+  barycentric(const v_list &vcl, const basic_tet<Index> &tet, const vert &point,
+              std::array<double, 4> &weights) {
+
+    const auto &v0 = vcl[tet[0]], &v1 = vcl[tet[1]], &v2 = vcl[tet[2]], &v3 = vcl[tet[3]];
+
+    std::array<double, 3> e1{}, e2{}, e3{}, d{};
+    for (int k = 0; k < 3; ++k) {
+      e1[k] = v1[k] - v0[k];
+      e2[k] = v2[k] - v0[k];
+      e3[k] = v3[k] - v0[k];
+      d[k] = point[k] - v0[k];
+    }
+
+    auto cross = [](const std::array<double, 3> &a, const std::array<double, 3> &b) {
+      return std::array<double, 3>{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    };
+    auto dot = [](const std::array<double, 3> &a, const std::array<double, 3> &b) {
+      return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    };
+
+    auto e2xe3 = cross(e2, e3);
+    double det = dot(e1, e2xe3);
+    if (det == 0.0) return false;
+
+    double inv = 1.0 / det;
+    weights[1] = dot(d, e2xe3) * inv;
+    weights[2] = dot(e1, cross(d, e3)) * inv;
+    weights[3] = dot(e1, cross(e2, d)) * inv;
+    weights[0] = 1.0 - weights[1] - weights[2] - weights[3];
+
+    return weights[0] >= -tolerance && weights[1] >= -tolerance
+        && weights[2] >= -tolerance && weights[3] >= -tolerance;
+
+  }
+
+  /**
+   * Find the tetrahedron containing a point, trying `hint` first.
+   */
+  template<typename Index>
+  Location
+  find(const v_list &vcl, const basic_tet_list<Index> &til, const vert &point, size_t hint) const {
+
+    Location location{no_tet, {0.0, 0.0, 0.0, 0.0}};
+
+    if (hint != no_tet && barycentric(vcl, til[hint], point, location.weights)) {
+      location.tet = hint;
+      return location;
+    }
+
+    if (_nodes.empty() || !_nodes[0].box.contains(point)) return location;
+
+    std::array<uint32_t, max_depth> stack;
+    size_t top = 0;
+    uint32_t current = 0;
+
+    while (true) {
+
+      const Node &node = _nodes[current];
+
+      if (node.count > 0) {
+        for (uint32_t i = node.index; i < node.index + node.count; ++i) {
+          if (barycentric(vcl, til[_tets[i]], point, location.weights)) {
+            location.tet = _tets[i];
+            return location;
+          }
+        }
+      } else {
+        bool first = _nodes[current + 1].box.contains(point);
+        bool second = _nodes[node.index].box.contains(point);
+        if (first) {
+          if (second) stack[top++] = node.index;
+          current += 1;
+          continue;
+        }
+        if (second) {
+          current = node.index;
+          continue;
+        }
+      }
+
+      if (top == 0) break;
+      current = stack[--top];
+
+    }
+
+    location.weights = {0.0, 0.0, 0.0, 0.0};
+    return location;
+
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_POINT_LOCATOR_HPP_
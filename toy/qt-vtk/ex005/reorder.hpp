@@ -0,0 +1,382 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_REORDER_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_REORDER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "aliases.hpp"
+#include "parallel.hpp"
+
+/**
+ * The orderings that a mesh can be renumbered with to improve the locality
+ * of its vertices and tetrahedra.
+ */
+enum class Ordering {
+  // Vertices and tetrahedra (by centroid) along a Morton (Z order) curve.
+  Morton,
+  // Vertices and tetrahedra (by centroid) along a Hilbert curve, which keeps
+  // consecutive cells adjacent.
+  Hilbert,
+  // Reverse Cuthill-McKee on the vertex graph, tetrahedra in the order of
+  // their first vertex. This gives the smallest bandwidth for sparse
+  // operators over the vertices.
+  ReverseCuthillMcKee
+};
+
+/**
+ * Parse the name of an ordering.
+ * @param name 'morton', 'hilbert' or 'rcm'.
+ * @return the ordering.
+ */
+inline Ordering
+ordering_from_name(const std::string &name) {
+  if (name == "morton") return Ordering::Morton;
+  if (name == "hilbert") return Ordering::Hilbert;
+  if (name == "rcm") return Ordering::ReverseCuthillMcKee;
+  throw std::invalid_argument("Unknown ordering '" + name + "', expected morton, hilbert or rcm.");
+}
+
+/**
+ * A renumbering of a mesh, each list gives the old index of every new
+ * index.
+ */
+struct MeshOrder {
+
+  // The old index of each vertex.
+  vi_list vertex_order;
+
+  // The old index of each tetrahedron.
+  teti_list tet_order;
+
+};
+
+namespace reorder {
+
+/**
+ * The number of bits per axis of the space filling curve keys.
+ */
+constexpr unsigned curve_bits = 21;
+
+/**
+ * Spread the low curve_bits bits of a value so that there are two zero bits
+ * between each of them.
+ */
+inline uint64_t
+spread_bits(uint32_t value) {
+
+  uint64_t x = value & ((1u << curve_bits) - 1);
+  x = (x | x << 32) & 0x001f00000000ffffull;
+  x = (x | x << 16) & 0x001f0000ff0000ffull;
+  x = (x | x << 8) & 0x100f00f00f00f00full;
+  x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+  x = (x | x << 2) & 0x1249249249249249ull;
+
+  return x;
+
+}
+
+/**
+ * Compute the Morton (Z order) key of a cell.
+ * @param x the cell coordinates, each less than 2^curve_bits.
+ * @return the key, the bits of the coordinates interleaved with x the most
+ *         significant.
+ */
+inline uint64_t
+morton_key(std::array<uint32_t, 3> x) {
+
+  return spread_bits(x[0]) << 2 | spread_bits(x[1]) << 1 | spread_bits(x[2]);
+
+}
+
+/**
+ * Compute the Hilbert key of a cell, with Skilling's transform ("Programming
+ * the Hilbert curve", AIP Conf. Proc. 707, 2004) followed by interleaving.
+ * @param x the cell coordinates, each less than 2^curve_bits.
+ * @return the key, cells with consecutive keys share a face.
+ */
+inline uint64_t
+hilbert_key(std::array<uint32_t, 3> x) {
+
+  constexpr uint32_t top = 1u << (curve_bits - 1);
+
+  // Inverse undo excess work, written with masks rather than branches as
+  // the branches are unpredictable.
+  for (uint32_t q = top; q > 1; q >>= 1) {
+    uint32_t p = q - 1;
+    for (int i = 0; i < 3; ++i) {
+      uint32_t set = 0u - ((x[i] & q) != 0);
+      uint32_t t = (x[0] ^ x[i]) & p & ~set;
+      x[0] ^= (p & set) | t;
+      x[i] ^= t;
+    }
+  }
+
+  // Gray encode.
+  for (int i = 1; i < 3; ++i) x[i] ^= x[i - 1];
+  uint32_t t = 0;
+  for (uint32_t q = top; q > 1; q >>= 1) {
+    t ^= (q - 1) & (0u - ((x[2] & q) != 0));
+  }
+  for (int i = 0; i < 3; ++i) x[i] ^= t;
+
+  return morton_key(x);
+
+}
+
+/**
+ * Sort indices by 63 bit keys, ties keep their index order.
+ * @param keys the key of each index.
+ * @return the indices in key order.
+ */
+inline std::vector<size_t>
+order_by_key(const std::vector<uint64_t> &keys) {
+
+  struct Record {
+    uint64_t key;
+    size_t index;
+  };
+
+  std::vector<Record> records(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) records[i] = {keys[i], i};
+
+  parallel_radix_sort(records, 3 * curve_bits, [](const Record &record, unsigned shift) {
+    return record.key >> shift;
+  });
+
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) order[i] = records[i].index;
+
+  return order;
+
+}
+
+/**
+ * Order vertices and tetrahedra along a space filling curve through the
+ * mesh's bounding box, tetrahedra by their centroids.
+ */
+template<typename Index>
+MeshOrder
+curve_order(const v_list &vcl, const basic_tet_list<Index> &til, Ordering ordering) {
+
+  std::array<double, 3> lo{}, hi{};
+  lo.fill(std::numeric_limits<double>::max());
+  hi.fill(std::numeric_limits<double>::lowest());
+  for (const auto &v : vcl) {
+    for (int k = 0; k < 3; ++k) {
+      lo[k] = std::min(lo[k], v[k]);
+      hi[k] = std::max(hi[k], v[k]);
+    }
+  }
+
+  // One scale for all axes, so that the curve's cells are cubes.
+  double extent = 0.0;
+  for (int k = 0; k < 3; ++k) extent = std::max(extent, hi[k] - lo[k]);
+  double scale = extent > 0.0 ? (double) ((1u << curve_bits) - 1) / extent : 0.0;
+
+  auto key = [&](const std::array<double, 3> &p) {
+    std::array<uint32_t, 3> cell{};
+    for (int k = 0; k < 3; ++k) {
+      cell[k] = (uint32_t) std::clamp((p[k] - lo[k]) * scale, 0.0, (double) ((1u << curve_bits) - 1));
+    }
+    return ordering == Ordering::Hilbert ? hilbert_key(cell) : morton_key(cell);
+  };
+
+  std::vector<uint64_t> vertex_keys(vcl.size());
+  parallel_for_blocks(vcl.size(), 1 << 14, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) vertex_keys[i] = key(vcl[i]);
+  });
+
+  std::vector<uint64_t> tet_keys(til.size());
+  parallel_for_blocks(til.size(), 1 << 14, [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      std::array<double, 3> centroid{};
+      for (auto i : til[t]) {
+        for (int k = 0; k < 3; ++k) centroid[k] += 0.25 * vcl[i][k];
+      }
+      tet_keys[t] = key(centroid);
+    }
+  });
+
+  return {order_by_key(vertex_keys), order_by_key(tet_keys)};
+
+}
+
+/**
+ * Order vertices with reverse Cuthill-McKee, then tetrahedra by their
+ * smallest new vertex index. Each connected component is started from a
+ * pseudo-peripheral vertex (George and Liu's search).
+ */
+template<typename Index>
+MeshOrder
+rcm_order(size_t n_verts, const basic_tet_list<Index> &til) {
+
+  if (n_verts > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Too many vertices for reverse Cuthill-McKee ordering.");
+  }
+
+  // Unique edges, packed as (smaller << 32 | larger) and sorted.
+  std::vector<uint64_t> edges(6 * til.size());
+  parallel_for_blocks(til.size(), 1 << 14, [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      size_t e = 6 * t;
+      for (size_t a = 0; a < 4; ++a) {
+        for (size_t b = a + 1; b < 4; ++b) {
+          auto u = (uint64_t) til[t][a], v = (uint64_t) til[t][b];
+          edges[e++] = std::min(u, v) << 32 | std::max(u, v);
+        }
+      }
+    }
+  });
+
+  parallel_radix_sort(edges, 64, [](uint64_t edge, unsigned shift) { return edge >> shift; });
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // Vertex graph in CSR form.
+  std::vector<size_t> offsets(n_verts + 1, 0);
+  for (uint64_t edge : edges) {
+    ++offsets[(edge >> 32) + 1];
+    ++offsets[(edge & 0xffffffffu) + 1];
+  }
+  for (size_t v = 0; v < n_verts; ++v) offsets[v + 1] += offsets[v];
+
+  std::vector<uint32_t> adjacent(offsets[n_verts]);
+  {
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint64_t edge : edges) {
+      auto u = (uint32_t) (edge >> 32), v = (uint32_t) (edge & 0xffffffffu);
+      adjacent[fill[u]++] = v;
+      adjacent[fill[v]++] = u;
+    }
+  }
+  edges = {};
+
+  auto degree = [&offsets](size_t v) { return offsets[v + 1] - offsets[v]; };
+
+  // Breadth first search from `root` over unnumbered vertices, appending
+  // to `order` with the neighbours of each vertex in increasing degree.
+  // Returns the index in `order` where the last level starts and the
+  // number of levels.
+  std::vector<uint32_t> mark(n_verts, 0);
+  uint32_t stamp = 0;
+
+  auto bfs = [&](size_t root, std::vector<size_t> &order) {
+
+    ++stamp;
+    size_t start = order.size();
+    order.push_back(root);
+    mark[root] = stamp;
+
+    size_t level_start = start, level_end = order.size(), last_level = start, n_levels = 0;
+    std::vector<uint32_t> next;
+
+    while (level_start < level_end) {
+      last_level = level_start;
+      ++n_levels;
+      for (size_t i = level_start; i < level_end; ++i) {
+        size_t v = order[i];
+        next.clear();
+        for (size_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+          uint32_t w = adjacent[j];
+          if (mark[w] == stamp || mark[w] == 0xffffffffu) continue;
+          mark[w] = stamp;
+          next.push_back(w);
+        }
+        std::sort(next.begin(), next.end(), [&degree](uint32_t a, uint32_t b) {
+          return degree(a) < degree(b) || (degree(a) == degree(b) && a < b);
+        });
+        order.insert(order.end(), next.begin(), next.end());
+      }
+      level_start = level_end;
+      level_end = order.size();
+    }
+
+    return std::pair{last_level, n_levels};
+
+  };
+
+  std::vector<size_t> vertex_order;
+  vertex_order.reserve(n_verts);
+  std::vector<size_t> trial;
+
+  for (size_t seed = 0; seed < n_verts; ++seed) {
+
+    if (mark[seed] == 0xffffffffu) continue;
+
+    // Move to a pseudo-peripheral vertex: repeatedly restart from the
+    // smallest degree vertex of the last level while that gets deeper.
+    size_t root = seed;
+    size_t depth = 0;
+    for (int iteration = 0; iteration < 8; ++iteration) {
+      trial.clear();
+      auto [last_level, n_levels] = bfs(root, trial);
+      if (n_levels <= depth) break;
+      depth = n_levels;
+      root = *std::min_element(trial.begin() + (std::ptrdiff_t) last_level, trial.end(),
+                               [&degree](size_t a, size_t b) { return degree(a) < degree(b); });
+    }
+
+    // Number the component from the chosen root.
+    size_t component_start = vertex_order.size();
+    bfs(root, vertex_order);
+    for (size_t i = component_start; i < vertex_order.size(); ++i) mark[vertex_order[i]] = 0xffffffffu;
+
+  }
+
+  std::reverse(vertex_order.begin(), vertex_order.end());
+
+  // Tetrahedra in order of their smallest new vertex index.
+  std::vector<size_t> new_index(n_verts);
+  for (size_t i = 0; i < n_verts; ++i) new_index[vertex_order[i]] = i;
+
+  struct Record {
+    uint64_t key;
+    size_t index;
+  };
+
+  std::vector<Record> records(til.size());
+  for (size_t t = 0; t < til.size(); ++t) {
+    size_t first = n_verts;
+    for (auto i : til[t]) first = std::min(first, new_index[i]);
+    records[t] = {first, t};
+  }
+
+  parallel_radix_sort(records, (size_t) std::bit_width(n_verts), [](const Record &record, unsigned shift) {
+    return record.key >> shift;
+  });
+
+  teti_list tet_order(til.size());
+  for (size_t t = 0; t < til.size(); ++t) tet_order[t] = records[t].index;
+
+  return {std::move(vertex_order), std::move(tet_order)};
+
+}
+
+}
+
+/**
+ * Compute an ordering of a mesh's vertices and tetrahedra.
+ * @param vcl the (v)ertex (c)oordinate (l)ist.
+ * @param til the (t)etrahedra (i)ndex (l)ist.
+ * @param ordering the ordering.
+ * @return the new order.
+ */
+template<typename Index>
+MeshOrder
+mesh_order(const v_list &vcl, const basic_tet_list<Index> &til, Ordering ordering) {
+  if (ordering == Ordering::ReverseCuthillMcKee) return reorder::rcm_order(vcl.size(), til);
+  return reorder::curve_order(vcl, til, ordering);
+}
+
+#endif // MMPPT_TOY_QT_VTK_EX005_REORDER_HPP_
@@ -0,0 +1,149 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_SUBMESHES_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_SUBMESHES_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "aliases.hpp"
+#include "parallel.hpp"
+
+/**
+ * The tetrahedra of a mesh partitioned by sub-mesh (material or grain). The
+ * tetrahedra are sorted by sub-mesh once and each sub-mesh keeps the range
+ * of the sorted list that holds its tetrahedra, so a sub-mesh is a view of
+ * that range rather than a copy. Within a sub-mesh the tetrahedra are in
+ * ascending order.
+ *
+ * Sub-meshes are identified by the values of the mesh's sub-mesh list and
+ * numbered 0 to size() - 1 in ascending order of those values.
+ */
+class SubMeshes {
+
+ public:
+
+  /**
+   * The tetrahedra of one sub-mesh.
+   */
+  struct View {
+
+    // The value of the sub-mesh list for these tetrahedra.
+    size_t id;
+
+    // The tetrahedra, in ascending order.
+    std::span<const size_t> tets;
+
+  };
+
+  /**
+   * Create an empty partition.
+   */
+  SubMeshes() = default;
+
+  /**
+   * Partition the tetrahedra of a mesh.
+   * @param sml the (s)ub-(m)esh list, one entry per tetrahedron.
+   */
+  explicit SubMeshes(const sm_list &sml) {
+
+    struct Record {
+      size_t id;
+      size_t tet;
+    };
+
+    std::vector<Record> records(sml.size());
+    size_t max_id = 0;
+    for (size_t t = 0; t < sml.size(); ++t) {
+      records[t] = {sml[t], t};
+      max_id = std::max(max_id, sml[t]);
+    }
+
+    // The sort is stable, so each sub-mesh's tetrahedra stay in order.
+    parallel_radix_sort(records, (size_t) std::bit_width(max_id), [](const Record &record, unsigned shift) {
+      return record.id >> shift;
+    });
+
+    _tets.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+      if (i == 0 || records[i].id != records[i - 1].id) {
+        _ids.push_back(records[i].id);
+        _offsets.push_back(i);
+      }
+      _tets[i] = records[i].tet;
+    }
+    _offsets.push_back(records.size());
+
+  }
+
+  /**
+   * Retrieve the number of sub-meshes.
+   * @return the number of sub-meshes.
+   */
+  [[nodiscard]] size_t
+  size() const { return _ids.size(); }
+
+  /**
+   * Retrieve the sub-mesh list value of every sub-mesh.
+   * @return the values, in ascending order.
+   */
+  [[nodiscard]] const std::vector<size_t> &
+  ids() const { return _ids; }
+
+  /**
+   * Find the number of a sub-mesh.
+   * @param id the sub-mesh list value.
+   * @return the number of the sub-mesh, or nothing if no tetrahedron has
+   *         this value.
+   */
+  [[nodiscard]] std::optional<size_t>
+  index_of(size_t id) const {
+    auto it = std::lower_bound(_ids.begin(), _ids.end(), id);
+    if (it == _ids.end() || *it != id) return std::nullopt;
+    return (size_t) (it - _ids.begin());
+  }
+
+  /**
+   * Retrieve a sub-mesh.
+   * @param index the number of the sub-mesh.
+   * @return a view of the sub-mesh's tetrahedra.
+   */
+  [[nodiscard]] View
+  operator[](size_t index) const {
+    return {_ids[index], {_tets.data() + _offsets[index], _tets.data() + _offsets[index + 1]}};
+  }
+
+  /**
+   * Retrieve the tetrahedra of every sub-mesh, sub-mesh by sub-mesh.
+   * @return the sorted tetrahedra.
+   */
+  [[nodiscard]] const teti_list &
+  tets() const { return _tets; }
+
+  /**
+   * Retrieve where each sub-mesh's tetrahedra start in tets().
+   * @return size() + 1 offsets.
+   */
+  [[nodiscard]] const std::vector<size_t> &
+  offsets() const { return _offsets; }
+
+ private:
+
+  // The sub-mesh list value of each sub-mesh.
+  std::vector<size_t> _ids;
+
+  // Where each sub-mesh starts in _tets, plus the end.
+  std::vector<size_t> _offsets;
+
+  // Tetrahedra sorted by sub-mesh.
+  teti_list _tets;
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_SUBMESHES_HPP_
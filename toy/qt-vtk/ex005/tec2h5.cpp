@@ -0,0 +1,95 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "load_tecplot.hpp"
+#include "model_hdf5.hpp"
+
+namespace {
+
+void
+usage(const char *exe) {
+
+  std::cerr << "usage: " << exe
+            << " [--reorder morton|hilbert|rcm] <input.tec|input.plt> <output.h5> [compression level 0-9]"
+            << std::endl;
+
+}
+
+/**
+ * Parse a compression level.
+ * @param str the compression level.
+ * @return the compression level, or nothing if it is not a whole number
+ *         from 0 to 9.
+ */
+std::optional<int>
+parse_compression_level(const std::string &str) {
+
+  try {
+    size_t end = 0;
+    int level = std::stoi(str, &end);
+    if (end == str.size() && level >= 0 && level <= 9) return level;
+  } catch (const std::exception &) {
+  }
+
+  return std::nullopt;
+
+}
+
+}
+
+/**
+ * Convert a tecplot file to the native HDF5 model format.
+ *
+ * usage: mmppt-tec2h5 [--reorder morton|hilbert|rcm] <input.tec|input.plt> <output.h5>
+ *                     [compression level 0-9]
+ *
+ * With --reorder the mesh is renumbered for locality before it is written,
+ * the original numbering is stored alongside it.
+ */
+int main(int argc, char *argv[]) {
+
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::optional<Ordering> ordering;
+
+  try {
+    if (args.size() >= 2 && args[0] == "--reorder") {
+      ordering = ordering_from_name(args[1]);
+      args.erase(args.begin(), args.begin() + 2);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (args.size() < 2 || args.size() > 3) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  auto compression_level = args.size() == 3 ? parse_compression_level(args[2]) : std::optional<int>{4};
+  if (!compression_level.has_value()) {
+    std::cerr << "Error: invalid compression level '" << args[2] << "'." << std::endl;
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    ModelHdf5::convert_tecplot(args[0], args[1], compression_level.value(), ordering);
+  } catch (const TecplotFileLoaderException &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,241 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_TECPLOT_GENERATOR_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_TECPLOT_GENERATOR_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Writes synthetic ASCII tecplot files with the same layout as the files
+ * read by TecplotFileLoader. The data is random (but reproducible for a
+ * given seed): vertices are uniform in the unit cube, tetrahedra reference
+ * random vertices and field vectors are random unit vectors. The content is
+ * meaningless, but the size and number formatting are representative.
+ */
+class TecplotGenerator {
+
+ public:
+
+  /**
+   * The ways in which floating point values are written.
+   */
+  enum class NumberFormat {
+    // Scientific notation with a fixed number of digits, e.g. -1.234567e-01.
+    Scientific,
+    // Fixed notation with a fixed number of digits, e.g. -0.123457.
+    Fixed,
+    // The shortest representation that round trips.
+    Shortest
+  };
+
+  /**
+   * The largest supported precision, more digits than this add nothing to a
+   * double.
+   */
+  static constexpr int max_precision = 17;
+
+  /**
+   * The parameters of a generated file.
+   */
+  struct Parameters {
+    size_t n_verts{100000};
+    size_t n_elems{400000};
+    size_t n_zones{10};
+    size_t n_submeshes{3};
+    NumberFormat number_format{NumberFormat::Scientific};
+    int precision{12};
+    size_t values_per_line{5};
+    uint64_t seed{1};
+  };
+
+  /**
+   * Write a file.
+   * @param file_name the name of the file.
+   * @param parameters the parameters of the file.
+   */
+  static void
+  write(const std::string &file_name, const Parameters &parameters) {
+
+    if (parameters.n_zones == 0 || parameters.values_per_line == 0) {
+      throw std::invalid_argument("A tecplot file needs at least one zone and one value per line.");
+    }
+    if (parameters.precision < 0 || parameters.precision > max_precision) {
+      throw std::invalid_argument("The precision must be between 0 and " + std::to_string(max_precision) + ".");
+    }
+
+    std::ofstream fout(file_name, std::ios::binary);
+    if (!fout) {
+      throw std::runtime_error("Could not open '" + file_name + "' for writing.");
+    }
+
+    Writer writer{fout, parameters};
+    std::mt19937_64 rng{parameters.seed};
+
+    writer.text("TITLE = \"synthetic\"\n");
+    writer.text("VARIABLES = \"X\",\"Y\",\"Z\",\"Mx\",\"My\",\"Mz\",\"SD\"\n");
+
+    std::uniform_real_distribution<double> unit{-1.0, 1.0};
+    std::uniform_int_distribution<size_t> vertex{1, std::max<size_t>(parameters.n_verts, 1)};
+    std::uniform_int_distribution<size_t> submesh{1, std::max<size_t>(parameters.n_submeshes, 1)};
+
+    std::vector<double> block(3 * parameters.n_verts);
+
+    for (size_t zone = 0; zone < parameters.n_zones; ++zone) {
+
+      writer.text("ZONE T=\"Br=" + std::to_string(zone) + ".0, Bb=0.5\" N="
+                      + std::to_string(parameters.n_verts) + ", E="
+                      + std::to_string(parameters.n_elems) + "\n");
+
+      if (zone == 0) {
+        // Vertex coordinates, x then y then z.
+        for (auto &value : block) value = 0.5 * (unit(rng) + 1.0);
+        writer.doubles(block);
+      }
+
+      // Random unit vectors, stored as mx then my then mz.
+      for (size_t i = 0; i < parameters.n_verts; ++i) {
+        double m[3] = {unit(rng), unit(rng), unit(rng)};
+        double norm = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+        if (norm == 0.0) norm = 1.0;
+        for (size_t c = 0; c < 3; ++c) {
+          block[c * parameters.n_verts + i] = m[c] / norm;
+        }
+      }
+      writer.doubles(block);
+
+      if (zone == 0) {
+        // Sub-mesh indices, then 1-based connectivity, one tetrahedron per
+        // line.
+        std::vector<size_t> submeshes(parameters.n_elems);
+        for (auto &value : submeshes) value = submesh(rng);
+        writer.ints(submeshes, 10);
+
+        std::vector<size_t> tet(4);
+        for (size_t i = 0; i < parameters.n_elems; ++i) {
+          for (auto &value : tet) value = vertex(rng);
+          writer.ints(tet, 4);
+        }
+      }
+
+    }
+
+    writer.flush();
+
+    if (!fout) {
+      throw std::runtime_error("Could not write '" + file_name + "'.");
+    }
+
+  }
+
+ private:
+
+  /**
+   * Formats values in to a buffer that is flushed to the stream in large
+   * blocks.
+   */
+  class Writer {
+
+   public:
+
+    Writer(std::ofstream &fout, const Parameters &parameters) :
+        _fout{fout},
+        _parameters{parameters} {
+      _buffer.reserve(buffer_size + 1024);
+    }
+
+    void
+    text(const std::string &str) {
+      _buffer += str;
+      flush_if_full();
+    }
+
+    void
+    doubles(const std::vector<double> &values) {
+
+      for (size_t i = 0; i < values.size(); ++i) {
+        append(values[i]);
+        _buffer.push_back(
+            (i + 1) % _parameters.values_per_line == 0 || i + 1 == values.size() ? '\n' : ' ');
+        flush_if_full();
+      }
+
+    }
+
+    void
+    ints(const std::vector<size_t> &values, size_t per_line) {
+
+      for (size_t i = 0; i < values.size(); ++i) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), values[i]);
+        _buffer.append(digits, result.ptr);
+        _buffer.push_back((i + 1) % per_line == 0 || i + 1 == values.size() ? '\n' : ' ');
+        flush_if_full();
+      }
+
+    }
+
+    void
+    flush() {
+      _fout.write(_buffer.data(), (std::streamsize) _buffer.size());
+      _buffer.clear();
+    }
+
+   private:
+
+    static constexpr size_t buffer_size = 1 << 20;
+
+    std::ofstream &_fout;
+
+    const Parameters &_parameters;
+
+    std::string _buffer;
+
+    void
+    append(double value) {
+
+      char digits[64];
+      std::to_chars_result result{};
+
+      switch (_parameters.number_format) {
+        case NumberFormat::Scientific:
+          result = std::to_chars(digits, digits + sizeof(digits), value,
+                                 std::chars_format::scientific, _parameters.precision);
+          break;
+        case NumberFormat::Fixed:
+          result = std::to_chars(digits, digits + sizeof(digits), value,
+                                 std::chars_format::fixed, _parameters.precision);
+          break;
+        case NumberFormat::Shortest:
+          result = std::to_chars(digits, digits + sizeof(digits), value);
+          break;
+      }
+
+      if (result.ec != std::errc{}) {
+        throw std::runtime_error("Could not format a value with precision "
+                                     + std::to_string(_parameters.precision) + ".");
+      }
+
+      _buffer.append(digits, result.ptr);
+
+    }
+
+    void
+    flush_if_full() {
+      if (_buffer.size() >= buffer_size) flush();
+    }
+
+  };
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_TECPLOT_GENERATOR_HPP_
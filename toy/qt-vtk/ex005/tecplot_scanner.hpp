@@ -0,0 +1,367 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_TECPLOT_SCANNER_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_TECPLOT_SCANNER_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+/**
+ * Hand-written line scanner for ASCII tecplot files. A line is classified
+ * by its first non-blank character and numbers are converted in place with
+ * `std::from_chars`, so no regular expressions or temporary strings are
+ * involved. The accepted grammar is exactly that of the regular expressions
+ * the loader used previously, i.e. lines that do not match are ignored.
+ */
+class TecplotScanner {
+
+ public:
+
+  /**
+   * The kind of line that has been scanned.
+   */
+  enum class LineType {
+    Other,
+    Zone,
+    IntLine,
+    FloatLine
+  };
+
+  /**
+   * Parsed contents of a 'ZONE T="..." N=... E=...' line.
+   */
+  struct ZoneHeader {
+    std::string_view title;
+    size_t n_verts;
+    size_t n_elems;
+  };
+
+  /**
+   * The location of a zone within a buffer.
+   */
+  struct ZoneSpan {
+    // The zone's header.
+    ZoneHeader header;
+    // Byte offset of the zone's 'ZONE' line.
+    size_t offset;
+    // Everything between the zone's 'ZONE' line and the next one.
+    std::string_view body;
+  };
+
+  /**
+   * Classify a line, for a zone line the header is parsed in to `header`.
+   * @param line the line to classify.
+   * @param header the zone header, only set if the line is a zone line.
+   * @return the line's type.
+   */
+  static LineType
+  classify(std::string_view line, ZoneHeader &header) {
+
+    const char *p = skip_blanks(line.data(), line.data() + line.size());
+    const char *end = line.data() + line.size();
+
+    if (p == end) return LineType::Other;
+
+    if (*p == 'Z') {
+      return match_zone(p, end, header) ? LineType::Zone : LineType::Other;
+    }
+
+    if (is_digit(*p) || *p == '-' || *p == '+' || *p == '.') {
+      return match_numeric(p, end);
+    }
+
+    return LineType::Other;
+
+  }
+
+  /**
+   * Apply `fn` to every line of a buffer, lines are passed as views in to
+   * the buffer without their terminating newline.
+   * @param buffer the buffer.
+   * @param fn function called with each line.
+   */
+  template<typename Fn>
+  static void
+  for_each_line(std::string_view buffer, Fn &&fn) {
+
+    const char *p = buffer.data();
+    const char *end = buffer.data() + buffer.size();
+
+    while (p != end) {
+      auto *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+      if (eol == nullptr) eol = end;
+      fn(std::string_view(p, eol - p));
+      p = eol == end ? end : eol + 1;
+    }
+
+  }
+
+  /**
+   * Apply `fn` to every unsigned integer on a line that has been classified
+   * as `LineType::IntLine`.
+   * @param line the line.
+   * @param fn function called with each value.
+   */
+  template<typename Fn>
+  static void
+  for_each_int(std::string_view line, Fn &&fn) {
+
+    const char *p = line.data();
+    const char *end = line.data() + line.size();
+
+    while ((p = skip_blanks(p, end)) != end) {
+      size_t value{};
+      auto [ptr, ec] = std::from_chars(p, end, value);
+      if (ec == std::errc::result_out_of_range) throw std::out_of_range("stoull");
+      fn(value);
+      p = ptr;
+    }
+
+  }
+
+  /**
+   * Apply `fn` to every floating point number on a line that has been
+   * classified as `LineType::FloatLine`.
+   * @param line the line.
+   * @param fn function called with each value.
+   */
+  template<typename Fn>
+  static void
+  for_each_double(std::string_view line, Fn &&fn) {
+
+    const char *p = line.data();
+    const char *end = line.data() + line.size();
+
+    while ((p = skip_blanks(p, end)) != end) {
+      // std::from_chars does not accept a leading '+'.
+      if (*p == '+') ++p;
+      double value{};
+      auto [ptr, ec] = std::from_chars(p, end, value);
+      if (ec == std::errc::result_out_of_range) throw std::out_of_range("stod");
+      fn(value);
+      p = ptr;
+    }
+
+  }
+
+  /**
+   * Quickly locate every zone in a buffer. Only the 'ZONE' lines themselves
+   * are parsed, the remainder of the buffer is skipped over.
+   * @param buffer the contents of a tecplot file.
+   * @param prelude set to everything that comes before the first zone.
+   * @return the zones, in the order they appear in the buffer.
+   */
+  static std::vector<ZoneSpan>
+  find_zones(std::string_view buffer, std::string_view &prelude) {
+
+    constexpr std::string_view keyword{"ZONE"};
+
+    std::vector<ZoneSpan> zones;
+    std::vector<size_t> body_offsets;
+
+    size_t pos = 0;
+    while ((pos = buffer.find(keyword, pos)) != std::string_view::npos) {
+
+      // The keyword must be the first non-blank text on its line.
+      size_t line_begin = pos;
+      while (line_begin > 0 && buffer[line_begin - 1] != '\n'
+          && is_blank(buffer[line_begin - 1])) {
+        --line_begin;
+      }
+
+      size_t line_end = std::min(buffer.find('\n', pos), buffer.size());
+
+      ZoneHeader header{};
+      if ((line_begin == 0 || buffer[line_begin - 1] == '\n')
+          && classify(buffer.substr(line_begin, line_end - line_begin), header) == LineType::Zone) {
+        zones.push_back({header, line_begin, {}});
+        body_offsets.push_back(std::min(line_end + 1, buffer.size()));
+      }
+
+      pos = line_end;
+
+    }
+
+    for (size_t i = 0; i < zones.size(); ++i) {
+      size_t body_end = i + 1 < zones.size() ? zones[i + 1].offset : buffer.size();
+      zones[i].body = buffer.substr(body_offsets[i], body_end - body_offsets[i]);
+    }
+
+    prelude = buffer.substr(0, zones.empty() ? buffer.size() : zones.front().offset);
+
+    return zones;
+
+  }
+
+ private:
+
+  static bool
+  is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+  }
+
+  static bool
+  is_digit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  static const char *
+  skip_blanks(const char *p, const char *end) {
+    while (p != end && is_blank(*p)) ++p;
+    return p;
+  }
+
+  static const char *
+  skip_digits(const char *p, const char *end) {
+    while (p != end && is_digit(*p)) ++p;
+    return p;
+  }
+
+  /**
+   * Match `[-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?` starting at `p`.
+   * @return one past the end of the number or nullptr if there is no match.
+   */
+  static const char *
+  match_float(const char *p, const char *end, bool &is_int) {
+
+    is_int = true;
+
+    if (p != end && (*p == '-' || *p == '+')) {
+      is_int = false;
+      ++p;
+    }
+
+    const char *q = skip_digits(p, end);
+    bool leading_digits = q != p;
+
+    if (q != end && *q == '.') {
+      is_int = false;
+      const char *r = skip_digits(q + 1, end);
+      if (r == q + 1) return nullptr;
+      q = r;
+    } else if (!leading_digits) {
+      return nullptr;
+    }
+
+    if (q != end && (*q == 'e' || *q == 'E')) {
+      is_int = false;
+      const char *r = q + 1;
+      if (r != end && (*r == '-' || *r == '+')) ++r;
+      const char *s = skip_digits(r, end);
+      if (s == r) return nullptr;
+      q = s;
+    }
+
+    return q;
+
+  }
+
+  /**
+   * Check that the remainder of a line is a blank separated list of numbers.
+   * A line that consists only of unsigned integers is an integer line.
+   */
+  static LineType
+  match_numeric(const char *p, const char *end) {
+
+    bool all_ints = true;
+
+    while (p != end) {
+
+      bool is_int;
+      const char *q = match_float(p, end, is_int);
+      if (q == nullptr) return LineType::Other;
+
+      all_ints = all_ints && is_int;
+
+      // Numbers must be separated by blanks.
+      p = skip_blanks(q, end);
+      if (p == q && p != end) return LineType::Other;
+
+    }
+
+    return all_ints ? LineType::IntLine : LineType::FloatLine;
+
+  }
+
+  /**
+   * Match a keyword, followed by optional blanks, '=' and optional blanks.
+   */
+  static const char *
+  match_assignment(const char *p, const char *end, char key) {
+
+    if (p == end || *p != key) return nullptr;
+    p = skip_blanks(p + 1, end);
+    if (p == end || *p != '=') return nullptr;
+    return skip_blanks(p + 1, end);
+
+  }
+
+  /**
+   * Match an unsigned integer and convert it.
+   */
+  static const char *
+  match_size(const char *p, const char *end, size_t &value) {
+
+    const char *q = skip_digits(p, end);
+    if (q == p) return nullptr;
+
+    auto [ptr, ec] = std::from_chars(p, q, value);
+    if (ec == std::errc::result_out_of_range) throw std::out_of_range("stoi");
+
+    return q;
+
+  }
+
+  static bool
+  is_title_char(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || is_digit(c)
+        || c == '=' || c == '-' || c == '.' || c == ',' || c == ';'
+        || is_blank(c);
+  }
+
+  /**
+   * Match `ZONE\s*T\s*=\s*"([A-Za-z0-9=\-.,;\s]+)?"\s*,?\s*N\s*=\s*([0-9]+)\s*,?\s*E\s*=\s*([0-9]+)\s*`.
+   */
+  static bool
+  match_zone(const char *p, const char *end, ZoneHeader &header) {
+
+    constexpr std::string_view keyword{"ZONE"};
+
+    if (std::string_view(p, end - p).substr(0, keyword.size()) != keyword) return false;
+    p = skip_blanks(p + keyword.size(), end);
+
+    // Title.
+    if ((p = match_assignment(p, end, 'T')) == nullptr) return false;
+    if (p == end || *p != '"') return false;
+    const char *title_begin = ++p;
+    while (p != end && is_title_char(*p)) ++p;
+    if (p == end || *p != '"') return false;
+    header.title = std::string_view(title_begin, p - title_begin);
+    p = skip_blanks(p + 1, end);
+    if (p != end && *p == ',') p = skip_blanks(p + 1, end);
+
+    // Number of vertices.
+    if ((p = match_assignment(p, end, 'N')) == nullptr) return false;
+    if ((p = match_size(p, end, header.n_verts)) == nullptr) return false;
+    p = skip_blanks(p, end);
+    if (p != end && *p == ',') p = skip_blanks(p + 1, end);
+
+    // Number of elements.
+    if ((p = match_assignment(p, end, 'E')) == nullptr) return false;
+    if ((p = match_size(p, end, header.n_elems)) == nullptr) return false;
+
+    return skip_blanks(p, end) == end;
+
+  }
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_TECPLOT_SCANNER_HPP_
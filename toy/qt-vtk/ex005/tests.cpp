@@ -0,0 +1,1279 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "field.hpp"
+#include "load_tecplot.hpp"
+#include "load_tecplot_binary.hpp"
+#include "mesh.hpp"
+#include "model_cache.hpp"
+#include "model_hdf5.hpp"
+#include "octahedral.hpp"
+#include "reorder.hpp"
+#include "submeshes.hpp"
+#include "tecplot_generator.hpp"
+#include "tecplot_scanner.hpp"
+
+/**
+ * Unit tests, each part of the loader and the mesh is checked against a
+ * brute force reference (the old regular expressions, a map of faces, a
+ * scan over every tetrahedron, ...) on small meshes and files.
+ *
+ * usage: mmppt-tests
+ */
+
+namespace {
+
+size_t n_failures = 0;
+
+/**
+ * Record the outcome of a check, failures are reported straight away.
+ * @param passed whether the check passed.
+ * @param what a description of the check.
+ */
+void
+check(bool passed, const std::string &what) {
+
+  if (!passed) {
+    std::cerr << "FAILED: " << what << std::endl;
+    ++n_failures;
+  }
+
+}
+
+/**
+ * A directory for the files written by a test, it is removed along with
+ * everything in it when it goes out of scope.
+ */
+class ScratchDirectory {
+
+ public:
+
+  explicit ScratchDirectory(const std::string &name) :
+      _path{std::filesystem::temp_directory_path()
+                / ("mmppt-tests-" + name + "-" + std::to_string(getpid()))} {
+    std::filesystem::remove_all(_path);
+    std::filesystem::create_directories(_path);
+  }
+
+  ~ScratchDirectory() {
+    std::error_code ec;
+    std::filesystem::remove_all(_path, ec);
+  }
+
+  [[nodiscard]] const std::filesystem::path &
+  path() const { return _path; }
+
+  [[nodiscard]] std::string
+  file(const std::string &name) const { return (_path / name).string(); }
+
+ private:
+
+  std::filesystem::path _path;
+
+};
+
+/**
+ * The parameters of a generated tecplot file that is small enough to be
+ * read many times.
+ * @param n_zones the number of zones.
+ * @return the parameters.
+ */
+TecplotGenerator::Parameters
+small_file(size_t n_zones = 4) {
+
+  TecplotGenerator::Parameters parameters;
+  parameters.n_verts = 500;
+  parameters.n_elems = 2000;
+  parameters.n_zones = n_zones;
+
+  return parameters;
+
+}
+
+/**
+ * Check that two models hold the same mesh and fields.
+ * @param a the first model.
+ * @param b the second model.
+ * @param tolerance how far, relative to the larger of one and the value,
+ *                  coordinates and field components may differ.
+ * @return true if the models are the same, otherwise false.
+ */
+bool
+same_model(const Model &a, const Model &b, double tolerance = 0.0) {
+
+  auto close = [tolerance](double x, double y) {
+    return std::abs(x - y) <= tolerance * std::max(1.0, std::abs(x));
+  };
+
+  const Mesh &m = a.mesh(), &n = b.mesh();
+  if (m.vcl().size() != n.vcl().size() || m.sml() != n.sml() || m.til().size() != n.til().size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < m.vcl().size(); ++i) {
+    for (size_t c = 0; c < 3; ++c) {
+      if (!close(m.vcl()[i][c], n.vcl()[i][c])) return false;
+    }
+  }
+
+  for (size_t t = 0; t < m.til().size(); ++t) {
+    if (m.til()[t] != n.til()[t]) return false;
+  }
+
+  const FieldList &f = a.field_list(), &g = b.field_list();
+  if (f.n_fields() != g.n_fields()) return false;
+
+  for (size_t z = 0; z < f.n_fields(); ++z) {
+    auto x = f.field(z), y = g.field(z);
+    if (x->annotation() != y->annotation() || x->size() != y->size()) return false;
+    for (size_t i = 0; i < x->size(); ++i) {
+      fv u = x->vector(i), v = y->vector(i);
+      for (size_t c = 0; c < 3; ++c) {
+        if (!close(u[c], v[c])) return false;
+      }
+    }
+  }
+
+  return true;
+
+}
+
+//---------------------------------------------------------------------------//
+// Tecplot generator.                                                        //
+//---------------------------------------------------------------------------//
+
+/**
+ * Generate the same file in each number format and check that they read
+ * back with the requested sizes and the same values.
+ */
+void
+test_generator() {
+
+  ScratchDirectory directory{"generator"};
+
+  auto parameters = small_file();
+  TecplotGenerator::write(directory.file("scientific.tec"), parameters);
+  Model reference = TecplotFileLoader::read(directory.file("scientific.tec"));
+
+  std::set<size_t> submeshes(reference.mesh().sml().begin(), reference.mesh().sml().end());
+  check(reference.mesh().vcl().size() == parameters.n_verts
+            && reference.mesh().til().size() == parameters.n_elems
+            && reference.field_list().n_fields() == parameters.n_zones
+            && submeshes.size() == parameters.n_submeshes,
+        "generated file has the requested sizes");
+
+  // Twelve digits, so the formats differ by rounding only.
+  double tolerance = std::max(1.0e-9, 2.0 * std::numeric_limits<field_scalar>::epsilon());
+
+  parameters.number_format = TecplotGenerator::NumberFormat::Fixed;
+  parameters.values_per_line = 7;
+  TecplotGenerator::write(directory.file("fixed.tec"), parameters);
+  check(same_model(reference, TecplotFileLoader::read(directory.file("fixed.tec")), tolerance),
+        "fixed and scientific files hold the same values");
+
+  parameters.number_format = TecplotGenerator::NumberFormat::Shortest;
+  parameters.values_per_line = 1;
+  TecplotGenerator::write(directory.file("shortest.tec"), parameters);
+  check(same_model(reference, TecplotFileLoader::read(directory.file("shortest.tec")), tolerance),
+        "shortest and scientific files hold the same values");
+
+  parameters.number_format = TecplotGenerator::NumberFormat::Fixed;
+  parameters.precision = TecplotGenerator::max_precision;
+  TecplotGenerator::write(directory.file("precise.tec"), parameters);
+  check(same_model(reference, TecplotFileLoader::read(directory.file("precise.tec")), tolerance),
+        "files at the largest precision hold the same values");
+
+  parameters.precision = TecplotGenerator::max_precision + 1;
+  bool threw = false;
+  try {
+    TecplotGenerator::write(directory.file("too_precise.tec"), parameters);
+  } catch (std::invalid_argument &) {
+    threw = true;
+  }
+  check(threw, "precision above the largest is rejected");
+
+}
+
+//---------------------------------------------------------------------------//
+// Tecplot scanner.                                                          //
+//---------------------------------------------------------------------------//
+
+/**
+ * Classify random lines with the scanner and with the regular expressions
+ * that the loader used before the scanner was written.
+ */
+void
+test_scanner() {
+
+  const std::regex zone_regex{
+      R"r(^\s*ZONE\s*T\s*=\s*"([A-Za-z0-9=\-.,;\s]+)?"\s*,?\s*N\s*=\s*([0-9]+)\s*,?\s*E\s*=\s*([0-9]+)\s*$)r"
+  };
+  const std::regex int_regex{R"r(^\s*([0-9]+)(\s+[0-9]+)*\s*$)r"};
+  const std::regex float_regex{
+      R"r(^\s*([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?)(\s+([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?))*\s*$)r"
+  };
+
+  std::mt19937_64 rng{1};
+  auto pick = [&rng](const std::vector<std::string> &pieces) {
+    return pieces[std::uniform_int_distribution<size_t>{0, pieces.size() - 1}(rng)];
+  };
+
+  // Numeric lines, built from the pieces of numbers so that most of them
+  // are nearly, but not quite, numbers.
+  const std::vector<std::string> number_pieces{"0", "7", "42", "123", ".", ".5", "-", "+", "e", "E", "e-",
+                                               "E+3", " ", " ", "\t", "x", ","};
+  size_t n_numeric = 0;
+
+  for (size_t i = 0; i < 200000; ++i) {
+
+    std::string line;
+    size_t n_pieces = std::uniform_int_distribution<size_t>{1, 6}(rng);
+    for (size_t k = 0; k < n_pieces; ++k) line += pick(number_pieces);
+
+    TecplotScanner::ZoneHeader header{};
+    auto type = TecplotScanner::classify(line, header);
+
+    auto expected = TecplotScanner::LineType::Other;
+    if (std::regex_match(line, int_regex)) {
+      expected = TecplotScanner::LineType::IntLine;
+    } else if (std::regex_match(line, float_regex)) {
+      expected = TecplotScanner::LineType::FloatLine;
+    }
+
+    check(type == expected, "scanner classifies '" + line + "'");
+    if (type != expected) continue;
+
+    // The values must be those that strtod gives for the blank separated
+    // tokens, integer lines are short enough to be exact in a double.
+    std::istringstream tokens{line};
+    std::vector<std::string> words{std::istream_iterator<std::string>{tokens}, {}};
+    // Numbers that are out of range throw, as std::stod did.
+    std::vector<double> expected_values;
+    bool out_of_range = false;
+    for (const auto &word : words) {
+      errno = 0;
+      expected_values.push_back(std::strtod(word.c_str(), nullptr));
+      out_of_range = out_of_range || errno == ERANGE;
+    }
+
+    std::vector<double> values;
+    bool threw = false;
+
+    try {
+      if (type == TecplotScanner::LineType::IntLine) {
+        TecplotScanner::for_each_int(line, [&values](size_t value) { values.push_back((double) value); });
+      } else if (type == TecplotScanner::LineType::FloatLine) {
+        TecplotScanner::for_each_double(line, [&values](double value) { values.push_back(value); });
+      } else {
+        continue;
+      }
+    } catch (std::out_of_range &) {
+      threw = true;
+    }
+
+    ++n_numeric;
+    check(threw == out_of_range && (threw || values == expected_values),
+          "scanner reads the numbers on '" + line + "'");
+
+  }
+
+  check(n_numeric > 1000, "scanner test generates enough numeric lines");
+
+  // Zone lines, a valid line with random optional blanks and commas, then
+  // possibly broken by a random edit.
+  const std::string title_chars{"AZaz09=-.,; \"x_"};
+  size_t n_zones = 0;
+
+  for (size_t i = 0; i < 50000; ++i) {
+
+    auto blank = [&]() { return pick({"", "", " ", "  ", "\t"}); };
+    auto comma = [&]() { return pick({"", ",", ", "}); };
+
+    std::string title;
+    size_t n_title = std::uniform_int_distribution<size_t>{0, 6}(rng);
+    for (size_t k = 0; k < n_title; ++k) {
+      title += title_chars[std::uniform_int_distribution<size_t>{0, title_chars.size() - 2}(rng)];
+    }
+
+    std::string line = blank() + "ZONE" + blank() + "T" + blank() + "=" + blank() + "\"" + title + "\""
+        + blank() + comma() + blank() + "N" + blank() + "=" + blank() + pick({"0", "12", "345"})
+        + blank() + comma() + blank() + "E" + blank() + "=" + blank() + pick({"1", "67", "8901"}) + blank();
+
+    if (std::uniform_int_distribution<int>{0, 1}(rng)) {
+      size_t at = std::uniform_int_distribution<size_t>{0, line.size() - 1}(rng);
+      char c = title_chars[std::uniform_int_distribution<size_t>{0, title_chars.size() - 1}(rng)];
+      switch (std::uniform_int_distribution<int>{0, 2}(rng)) {
+        case 0: line[at] = c; break;
+        case 1: line.insert(line.begin() + (long) at, c); break;
+        default: line.erase(at, 1); break;
+      }
+    }
+
+    TecplotScanner::ZoneHeader header{};
+    auto type = TecplotScanner::classify(line, header);
+
+    std::smatch match;
+    bool expected = std::regex_match(line, match, zone_regex);
+
+    check((type == TecplotScanner::LineType::Zone) == expected, "scanner classifies '" + line + "'");
+    if (!expected || type != TecplotScanner::LineType::Zone) continue;
+
+    ++n_zones;
+    check(header.title == match[1].str()
+              && header.n_verts == std::stoull(match[2].str())
+              && header.n_elems == std::stoull(match[3].str()),
+          "scanner reads the zone header '" + line + "'");
+
+  }
+
+  check(n_zones > 1000, "scanner test generates enough zone lines");
+
+}
+
+//---------------------------------------------------------------------------//
+// Read paths.                                                               //
+//---------------------------------------------------------------------------//
+
+/**
+ * Read the same file through a memory mapping and through a stream.
+ */
+void
+test_mapped_read() {
+
+  ScratchDirectory directory{"mapped"};
+  std::string file_name = directory.file("model.tec");
+  TecplotGenerator::write(file_name, small_file());
+
+  Model mapped = TecplotFileLoader::read(file_name, TecplotFileLoader::ReadMode::Mapped);
+  Model stream = TecplotFileLoader::read(file_name, TecplotFileLoader::ReadMode::Stream);
+  Model automatic = TecplotFileLoader::read(file_name);
+
+  check(same_model(mapped, stream), "mapped and stream reads agree");
+  check(same_model(mapped, automatic), "mapped and automatic reads agree");
+
+}
+
+/**
+ * Parse the zones of a file on one thread and on several.
+ */
+void
+test_parallel_read() {
+
+  ScratchDirectory directory{"parallel"};
+  std::string file_name = directory.file("model.tec");
+  auto parameters = small_file(24);
+  parameters.values_per_line = 3;
+  TecplotGenerator::write(file_name, parameters);
+
+  Model serial = TecplotFileLoader::read(file_name, TecplotFileLoader::ReadMode::Mapped, 1);
+
+  for (size_t n_threads : {2, 4, 16}) {
+    Model parallel = TecplotFileLoader::read(file_name, TecplotFileLoader::ReadMode::Mapped, n_threads);
+    check(same_model(serial, parallel),
+          "parsing on " + std::to_string(n_threads) + " threads agrees with one thread");
+  }
+
+}
+
+//---------------------------------------------------------------------------//
+// Lazy fields.                                                              //
+//---------------------------------------------------------------------------//
+
+/**
+ * A field source that counts how often each field is decoded.
+ */
+class CountingSource : public FieldSource {
+
+ public:
+
+  CountingSource(size_t n_fields, size_t n_verts) :
+      loads(n_fields, 0),
+      _n_verts{n_verts} {}
+
+  [[nodiscard]] size_t
+  n_fields() const override { return loads.size(); }
+
+  [[nodiscard]] Field
+  load(size_t index) const override {
+    loads.at(index)++;
+    return {"zone " + std::to_string(index), fv_list(_n_verts, fv{(field_scalar) index, 0, 1})};
+  }
+
+  // The number of times each field has been decoded.
+  mutable std::vector<size_t> loads;
+
+ private:
+
+  size_t _n_verts;
+
+};
+
+/**
+ * Compare a lazy read with an eager one, and the residency of a lazy field
+ * list with a reference least recently used cache.
+ */
+void
+test_lazy_fields() {
+
+  ScratchDirectory directory{"lazy"};
+  std::string file_name = directory.file("model.tec");
+  TecplotGenerator::write(file_name, small_file(12));
+
+  Model lazy = TecplotFileLoader::read_lazy(file_name, 3);
+  check(lazy.field_list().is_lazy(), "lazy read gives a lazy field list");
+  check(same_model(TecplotFileLoader::read(file_name), lazy), "lazy and eager reads agree");
+  check(lazy.field_list().n_resident() <= 3, "lazy read keeps at most max_resident zones");
+
+  size_t n_fields = 10, max_resident = 3;
+  auto source = std::make_shared<CountingSource>(n_fields, 8);
+  FieldList field_list{source, max_resident};
+
+  // Held handles outlive the eviction of their field.
+  auto held = field_list.field(0);
+
+  std::mt19937_64 rng{10};
+  std::uniform_int_distribution<size_t> index{0, n_fields - 1};
+  std::list<size_t> reference{0};
+  size_t n_loads = 1;
+  bool same = true;
+
+  for (size_t i = 0; i < 2000; ++i) {
+
+    size_t z = index(rng);
+    auto field = field_list.field(z);
+
+    auto it = std::find(reference.begin(), reference.end(), z);
+    if (it == reference.end()) {
+      ++n_loads;
+      reference.push_front(z);
+      if (reference.size() > max_resident) reference.pop_back();
+    } else {
+      reference.splice(reference.begin(), reference, it);
+    }
+
+    size_t loaded = std::accumulate(source->loads.begin(), source->loads.end(), size_t{0});
+    same = same && loaded == n_loads && field_list.n_resident() == reference.size()
+        && field->vector(7)[0] == (field_scalar) z;
+
+  }
+
+  check(same, "lazy fields are decoded and evicted least recently used first");
+  check(held->annotation() == "zone 0" && held->vector(0)[0] == 0, "held field outlives its eviction");
+
+}
+
+//---------------------------------------------------------------------------//
+// Model cache.                                                              //
+//---------------------------------------------------------------------------//
+
+/**
+ * Round trip a model through the model cache.
+ */
+void
+test_model_cache() {
+
+  ScratchDirectory directory{"cache"};
+  std::string file_name = directory.file("model.tec");
+  TecplotGenerator::write(file_name, small_file());
+
+  Model model = TecplotFileLoader::read(file_name);
+  ModelCache cache{directory.path() / "cache"};
+
+  check(!cache.load(file_name).has_value(), "there is no cache before one is written");
+  check(cache.store(file_name, model), "model cache is written");
+
+  auto cached = cache.load(file_name);
+  check(cached.has_value() && same_model(model, cached.value()), "model cache round trip");
+  check(same_model(model, cache.load_or_read(file_name)), "load_or_read uses the cache");
+  check(cache.is_current(file_name), "a written cache is up-to-date");
+
+  // A changed source invalidates its cache, load_or_read parses it without
+  // writing a new one and update rewrites it.
+  std::ofstream{file_name, std::ios::app} << "\n";
+  check(!cache.load(file_name).has_value(), "a changed source invalidates the cache");
+  check(same_model(model, cache.load_or_read(file_name)) && !cache.is_current(file_name),
+        "load_or_read does not write the cache");
+  check(cache.update(file_name) && cache.is_current(file_name), "update writes the cache");
+  cached = cache.load(file_name);
+  check(cached.has_value() && same_model(model, cached.value()), "updated cache round trip");
+
+}
+
+//---------------------------------------------------------------------------//
+// HDF5 files.                                                               //
+//---------------------------------------------------------------------------//
+
+/**
+ * Round trip a model, whole and a range of zones at a time, through the
+ * HDF5 format.
+ */
+void
+test_hdf5() {
+
+  ScratchDirectory directory{"hdf5"};
+  std::string tecplot_file = directory.file("model.tec");
+  auto parameters = small_file();
+  TecplotGenerator::write(tecplot_file, parameters);
+  Model model = TecplotFileLoader::read(tecplot_file);
+
+  for (int compression_level : {0, 4}) {
+
+    std::string file_name = directory.file("model-" + std::to_string(compression_level) + ".h5");
+    ModelHdf5::write(model, file_name, compression_level);
+    check(same_model(model, ModelHdf5::read(file_name)), "HDF5 round trip");
+
+    auto zones = ModelHdf5::read_zones(file_name, 1, 2);
+    bool same = zones.size() == 2 && ModelHdf5::n_zones(file_name) == parameters.n_zones;
+    for (size_t z = 0; same && z < zones.size(); ++z) {
+      auto field = model.field_list().field(z + 1);
+      same = zones[z].annotation() == field->annotation();
+      for (size_t i = 0; same && i < field->size(); ++i) same = zones[z].vector(i) == field->vector(i);
+    }
+    check(same, "HDF5 zone range round trip");
+
+  }
+
+  // Many zones with long titles, more than fit in an HDF5 attribute.
+  FieldList fields;
+  for (size_t z = 0; z < 3000; ++z) {
+    fields.add_field(Field{"ZONE T=\"Br=" + std::to_string(z) + ".0, Bb=0.5, a long title\"",
+                           fv_list{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {(field_scalar) z, 0, 0}}});
+  }
+  Model many{v_list{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}}, Connectivity{tet_list{{0, 1, 2, 3}}},
+             sm_list{1}, std::move(fields)};
+
+  std::string file_name = directory.file("many.h5");
+  ModelHdf5::write(many, file_name, 0);
+  check(same_model(many, ModelHdf5::read(file_name)), "HDF5 round trip of many zones");
+
+}
+
+//---------------------------------------------------------------------------//
+// Binary tecplot files.                                                     //
+//---------------------------------------------------------------------------//
+
+/**
+ * Write a model as a binary tecplot file (format version 112), the first
+ * zone holds the geometry and the others share it.
+ * @param file_name the name of the file.
+ * @param model the model.
+ * @param single_precision whether to write the fields as floats rather
+ *                         than doubles.
+ */
+void
+write_plt(const std::string &file_name, const Model &model, bool single_precision) {
+
+  std::ofstream fout(file_name, std::ios::binary);
+
+  auto put = [&fout](auto value) { fout.write(reinterpret_cast<const char *>(&value), sizeof(value)); };
+  auto text = [&put](const std::string &str) {
+    for (char c : str) put((int32_t) c);
+    put((int32_t) 0);
+  };
+
+  const Mesh &mesh = model.mesh();
+  const FieldList &field_list = model.field_list();
+  auto n_verts = (int32_t) mesh.vcl().size(), n_elems = (int32_t) mesh.til().size();
+
+  // Header, with a dataset auxiliary record that is skipped.
+  fout.write("#!TDV112", 8);
+  put((int32_t) 1);
+  put((int32_t) 0);
+  text("synthetic");
+  put((int32_t) 7);
+  for (const auto &name : {"X", "Y", "Z", "Mx", "My", "Mz", "SD"}) text(name);
+  put(799.0f);
+  text("Solver");
+  put((int32_t) 0);
+  text("merrill");
+
+  for (size_t z = 0; z < field_list.n_fields(); ++z) {
+    put(299.0f);
+    text(field_list.field(z)->annotation());
+    put((int32_t) -1);
+    put((int32_t) -1);
+    put(0.0);
+    put((int32_t) -1);
+    put((int32_t) 4);
+    // Variable locations, SD is cell centred.
+    put((int32_t) 1);
+    for (int32_t var = 0; var < 7; ++var) put((int32_t) (var == 6));
+    put((int32_t) 0);
+    put((int32_t) 0);
+    put(n_verts);
+    put(n_elems);
+    for (int k = 0; k < 4; ++k) put((int32_t) 0);
+  }
+  put(357.0f);
+
+  for (size_t z = 0; z < field_list.n_fields(); ++z) {
+
+    put(299.0f);
+    for (int32_t var = 0; var < 7; ++var) put((int32_t) (var == 6 ? 3 : var >= 3 && single_precision ? 1 : 2));
+    put((int32_t) 0);
+
+    if (z == 0) {
+      put((int32_t) 0);
+      put((int32_t) -1);
+      for (int k = 0; k < 14; ++k) put(0.0);
+      for (size_t c = 0; c < 3; ++c) {
+        for (const auto &v : mesh.vcl()) put(v[c]);
+      }
+    } else {
+      // Coordinates, SD and connectivity are shared with the first zone.
+      put((int32_t) 1);
+      for (int32_t var = 0; var < 7; ++var) put((int32_t) (var < 3 || var == 6 ? 0 : -1));
+      put((int32_t) 0);
+      for (int k = 0; k < 6; ++k) put(0.0);
+    }
+
+    auto field = field_list.field(z);
+    for (size_t c = 0; c < 3; ++c) {
+      for (size_t i = 0; i < field->size(); ++i) {
+        if (single_precision) put((float) field->vector(i)[c]);
+        else put((double) field->vector(i)[c]);
+      }
+    }
+
+    if (z == 0) {
+      for (size_t id : mesh.sml()) put((int32_t) id);
+      for (size_t t = 0; t < mesh.til().size(); ++t) {
+        for (size_t v : mesh.til()[t]) put((int32_t) v);
+      }
+    }
+
+  }
+
+}
+
+/**
+ * Read binary tecplot files written from an ASCII file and compare them
+ * with it, and check that damaged files are rejected.
+ */
+void
+test_binary_read() {
+
+  ScratchDirectory directory{"binary"};
+  std::string tecplot_file = directory.file("model.tec");
+  TecplotGenerator::write(tecplot_file, small_file());
+  Model model = TecplotFileLoader::read(tecplot_file);
+
+  std::string double_file = directory.file("double.plt");
+  write_plt(double_file, model, false);
+  check(same_model(model, TecplotBinaryFileLoader::read(double_file)), "binary file with double fields");
+  check(same_model(model, TecplotBinaryFileLoader::read(double_file, 1)), "binary file read on one thread");
+
+  std::string float_file = directory.file("float.plt");
+  write_plt(float_file, model, true);
+  check(same_model(model, TecplotBinaryFileLoader::read(float_file), std::numeric_limits<float>::epsilon()),
+        "binary file with float fields");
+
+  // Truncated files.
+  std::ifstream fin(double_file, std::ios::binary);
+  std::string contents{std::istreambuf_iterator<char>{fin}, {}};
+  for (size_t size : {size_t{6}, size_t{100}, contents.size() / 2, contents.size() - 1}) {
+    std::string truncated_file = directory.file("truncated.plt");
+    std::ofstream{truncated_file, std::ios::binary | std::ios::trunc}.write(contents.data(), (std::streamsize) size);
+    bool threw = false;
+    try {
+      (void) TecplotBinaryFileLoader::read(truncated_file);
+    } catch (TecplotFileLoaderException &) {
+      threw = true;
+    }
+    check(threw, "binary file truncated to " + std::to_string(size) + " bytes is rejected");
+  }
+
+}
+
+//---------------------------------------------------------------------------//
+// Octahedral encoding.                                                      //
+//---------------------------------------------------------------------------//
+
+/**
+ * Round trip random directions, and directions on and next to the
+ * octahedron's edges and vertices, through the encoding.
+ */
+void
+test_octahedral() {
+
+  std::mt19937_64 rng{8};
+  std::normal_distribution<double> normal;
+  std::uniform_real_distribution<double> small{-1.0e-4, 1.0e-4};
+  std::uniform_real_distribution<double> length{0.1, 10.0};
+
+  std::vector<vert> directions;
+  for (size_t i = 0; i < 200000; ++i) {
+    vert v{normal(rng), normal(rng), normal(rng)};
+    if (i % 4 == 1) v[std::uniform_int_distribution<size_t>{0, 2}(rng)] = small(rng);
+    if (i % 4 == 2) v = {small(rng), small(rng), i % 8 < 4 ? 1.0 : -1.0};
+    double norm = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    directions.push_back({v[0] / norm, v[1] / norm, v[2] / norm});
+  }
+
+  OctahedralVectors unit{directions.size(), [&](size_t i) { return directions[i]; }};
+  check(!unit.has_magnitudes(), "unit vectors are stored without magnitudes");
+
+  std::vector<double> decoded(3 * directions.size());
+  unit.decode(0, directions.size(), decoded.data());
+
+  double worst = 0.0;
+  for (size_t i = 0; i < directions.size(); ++i) {
+    const double *d = decoded.data() + 3 * i;
+    vert c{directions[i][1] * d[2] - directions[i][2] * d[1], directions[i][2] * d[0] - directions[i][0] * d[2],
+           directions[i][0] * d[1] - directions[i][1] * d[0]};
+    double dot = directions[i][0] * d[0] + directions[i][1] * d[1] + directions[i][2] * d[2];
+    worst = std::max(worst, std::atan2(std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]), dot));
+  }
+  check(worst <= OctahedralVectors::max_angular_error, "octahedral angular error is within its bound");
+
+  std::vector<double> lengths(directions.size());
+  for (auto &l : lengths) l = length(rng);
+  OctahedralVectors scaled{directions.size(), [&](size_t i) {
+    return vert{lengths[i] * directions[i][0], lengths[i] * directions[i][1], lengths[i] * directions[i][2]};
+  }};
+  check(scaled.has_magnitudes(), "vectors that are not unit vectors keep their magnitudes");
+
+  scaled.decode(0, directions.size(), decoded.data());
+  double magnitude_error = 0.0;
+  for (size_t i = 0; i < directions.size(); ++i) {
+    const double *d = decoded.data() + 3 * i;
+    double norm = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    magnitude_error = std::max(magnitude_error, std::abs(norm - lengths[i]) / lengths[i]);
+  }
+  check(magnitude_error < 1.0e-6, "octahedral magnitudes are kept in single precision");
+
+}
+
+/**
+ * A Kuhn subdivision of an n x n x n grid of unit cubes, six tetrahedra
+ * per cube.
+ */
+struct Grid {
+  v_list vcl;
+  tet32_list til;
+  sm_list sml;
+};
+
+/**
+ * Create a grid.
+ * @param n the number of cubes along each axis.
+ * @param jitter how far, at most, interior vertices are moved from their
+ *               grid position along each axis.
+ * @param shuffle whether to shuffle the vertex and tetrahedron numbering.
+ * @param seed the random seed.
+ * @return the grid, cubes in the lower half along x are in sub-mesh 0 and
+ *         the others in sub-mesh 1.
+ */
+Grid
+kuhn_grid(size_t n, double jitter, bool shuffle, uint64_t seed) {
+
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<double> offset{-jitter, jitter};
+
+  size_t n_verts = (n + 1) * (n + 1) * (n + 1);
+  std::vector<size_t> number(n_verts);
+  std::iota(number.begin(), number.end(), 0);
+  if (shuffle) std::shuffle(number.begin(), number.end(), rng);
+
+  auto id = [&](size_t i, size_t j, size_t k) { return number[(i * (n + 1) + j) * (n + 1) + k]; };
+  auto move = [&](size_t i) { return (i == 0 || i == n) ? 0.0 : offset(rng); };
+
+  Grid grid;
+  grid.vcl.resize(n_verts);
+  for (size_t i = 0; i <= n; ++i) {
+    for (size_t j = 0; j <= n; ++j) {
+      for (size_t k = 0; k <= n; ++k) {
+        grid.vcl[id(i, j, k)] = {(double) i + move(i), (double) j + move(j), (double) k + move(k)};
+      }
+    }
+  }
+
+  constexpr std::array<std::array<size_t, 3>, 6> axes{{{0, 1, 2}, {0, 2, 1}, {1, 0, 2},
+                                                       {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      for (size_t k = 0; k < n; ++k) {
+        for (const auto &axis : axes) {
+          std::array<size_t, 3> c{i, j, k};
+          tet32 t;
+          t[0] = id(c[0], c[1], c[2]);
+          for (size_t s = 0; s < 3; ++s) {
+            c[axis[s]]++;
+            t[s + 1] = id(c[0], c[1], c[2]);
+          }
+          grid.til.push_back(t);
+          grid.sml.push_back(i < n / 2 ? 0 : 1);
+        }
+      }
+    }
+  }
+
+  if (shuffle) {
+    std::vector<size_t> order(grid.til.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    tet32_list til(order.size());
+    sm_list sml(order.size());
+    for (size_t t = 0; t < order.size(); ++t) {
+      til[t] = grid.til[order[t]];
+      sml[t] = grid.sml[order[t]];
+    }
+    grid.til = std::move(til);
+    grid.sml = std::move(sml);
+  }
+
+  return grid;
+
+}
+
+//---------------------------------------------------------------------------//
+// Topology.                                                                 //
+//---------------------------------------------------------------------------//
+
+/**
+ * Compare the surface faces with those found from a map of every
+ * tetrahedron's faces.
+ */
+void
+test_surface_faces() {
+
+  Grid grid = kuhn_grid(5, 0.2, true, 2);
+  Mesh mesh{grid.vcl, Connectivity{grid.til}, grid.sml};
+
+  std::map<std::array<size_t, 3>, std::vector<size_t>> face_tets;
+  for (size_t t = 0; t < grid.til.size(); ++t) {
+    for (size_t skip = 0; skip < 4; ++skip) {
+      std::array<size_t, 3> face{};
+      for (size_t c = 0, k = 0; c < 4; ++c) {
+        if (c != skip) face[k++] = grid.til[t][c];
+      }
+      std::sort(face.begin(), face.end());
+      face_tets[face].push_back(t);
+    }
+  }
+
+  std::set<std::array<size_t, 3>> expected;
+  for (const auto &[face, tets] : face_tets) {
+    if (tets.size() == 1 || grid.sml[tets[0]] != grid.sml[tets[1]]) expected.insert(face);
+  }
+
+  mesh.topology().visit([&]<typename Id>(const BasicTopology<Id> &topology) {
+
+    check(topology.n_faces() == face_tets.size(), "topology has every face once");
+
+    std::set<std::array<size_t, 3>> found;
+    for (Id face : topology.surface_faces(mesh.sml())) {
+      const auto &vertices = topology.faces()[face];
+      found.insert({vertices[0], vertices[1], vertices[2]});
+    }
+
+    check(found == expected, "surface faces are the boundary and sub-mesh interfaces");
+
+    bool neighbours = true;
+    for (size_t t = 0; t < grid.til.size(); ++t) {
+      for (size_t f = 0; f < 4; ++f) {
+        const auto &vertices = topology.faces()[topology.tet_faces(t)[f]];
+        const auto &tets = face_tets[{vertices[0], vertices[1], vertices[2]}];
+        size_t other = tets.size() == 1 ? BasicTopology<Id>::no_tet : (tets[0] == t ? tets[1] : tets[0]);
+        neighbours = neighbours && (size_t) topology.tet_neighbours(t)[f] == (size_t) other;
+      }
+    }
+    check(neighbours, "tetrahedron neighbours share a face");
+
+  });
+
+}
+
+/**
+ * Compute the barycentric coordinates of a point with respect to a
+ * tetrahedron by Cramer's rule.
+ */
+std::array<double, 4>
+barycentric(const v_list &vcl, const tet32 &t, const vert &p) {
+
+  auto sub = [](const vert &a, const vert &b) { return vert{a[0] - b[0], a[1] - b[1], a[2] - b[2]}; };
+  auto det = [](const vert &a, const vert &b, const vert &c) {
+    return a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0])
+        + a[2] * (b[0] * c[1] - b[1] * c[0]);
+  };
+
+  vert e1 = sub(vcl[t[1]], vcl[t[0]]), e2 = sub(vcl[t[2]], vcl[t[0]]), e3 = sub(vcl[t[3]], vcl[t[0]]);
+  vert r = sub(p, vcl[t[0]]);
+  double d = det(e1, e2, e3);
+
+  double w1 = det(r, e2, e3) / d, w2 = det(e1, r, e3) / d, w3 = det(e1, e2, r) / d;
+  return {1.0 - w1 - w2 - w3, w1, w2, w3};
+
+}
+
+//---------------------------------------------------------------------------//
+// Point locator.                                                            //
+//---------------------------------------------------------------------------//
+
+/**
+ * Locate random points and compare with a scan over every tetrahedron.
+ */
+void
+test_locator() {
+
+  size_t n = 6;
+  Grid grid = kuhn_grid(n, 0.2, true, 3);
+  Mesh mesh{grid.vcl, Connectivity{grid.til}, grid.sml};
+
+  std::mt19937_64 rng{4};
+  std::uniform_real_distribution<double> coordinate{-0.5, (double) n + 0.5};
+  std::vector<vert> points(2000);
+  for (auto &point : points) point = {coordinate(rng), coordinate(rng), coordinate(rng)};
+
+  std::vector<PointLocator::Location> locations(points.size());
+  mesh.locate(points, locations);
+
+  for (size_t q = 0; q < points.size(); ++q) {
+
+    // The most inside any tetrahedron the point is.
+    double best = -std::numeric_limits<double>::infinity();
+    for (const auto &t : grid.til) {
+      auto weights = barycentric(grid.vcl, t, points[q]);
+      best = std::max(best, *std::min_element(weights.begin(), weights.end()));
+    }
+
+    const auto &location = locations[q];
+    if (location.tet == PointLocator::no_tet) {
+      check(best < 1.0e-9, "locator finds every point inside the mesh");
+      continue;
+    }
+
+    const auto &t = grid.til[location.tet];
+    auto weights = barycentric(grid.vcl, t, points[q]);
+    double error = 0.0;
+    for (size_t c = 0; c < 4; ++c) error = std::max(error, std::abs(weights[c] - location.weights[c]));
+
+    check(*std::min_element(weights.begin(), weights.end()) > -1.0e-9, "located tetrahedron contains the point");
+    check(error < 1.0e-9, "locator gives the point's barycentric coordinates");
+
+  }
+
+  auto single = mesh.locate(points[0]);
+  check(single.has_value() == (locations[0].tet != PointLocator::no_tet)
+            && (!single || single->tet == locations[0].tet),
+        "single and batched queries agree");
+
+}
+
+//---------------------------------------------------------------------------//
+// Orderings.                                                                //
+//---------------------------------------------------------------------------//
+
+/**
+ * Check the curve keys against their definitions and that every ordering
+ * is a permutation which leaves the mesh itself unchanged.
+ */
+void
+test_orderings() {
+
+  std::mt19937_64 rng{5};
+  std::uniform_int_distribution<uint32_t> cell{0, (1u << reorder::curve_bits) - 1};
+
+  bool morton = true;
+  for (size_t i = 0; i < 10000; ++i) {
+    std::array<uint32_t, 3> x{cell(rng), cell(rng), cell(rng)};
+    uint64_t key = 0;
+    for (unsigned bit = 0; bit < reorder::curve_bits; ++bit) {
+      for (size_t axis = 0; axis < 3; ++axis) {
+        key |= (uint64_t) ((x[axis] >> bit) & 1u) << (3 * bit + 2 - axis);
+      }
+    }
+    morton = morton && reorder::morton_key(x) == key;
+  }
+  check(morton, "Morton keys interleave the coordinate bits");
+
+  // Consecutive Hilbert cells share a face, checked on an 8 x 8 x 8 grid of
+  // the coarsest cells.
+  std::vector<std::pair<uint64_t, std::array<int, 3>>> cells;
+  uint32_t step = 1u << (reorder::curve_bits - 3);
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      for (int k = 0; k < 8; ++k) {
+        cells.push_back({reorder::hilbert_key({i * step, j * step, k * step}), {i, j, k}});
+      }
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+  bool hilbert = true;
+  for (size_t c = 1; c < cells.size(); ++c) {
+    int distance = 0;
+    for (size_t axis = 0; axis < 3; ++axis) distance += std::abs(cells[c].second[axis] - cells[c - 1].second[axis]);
+    hilbert = hilbert && distance == 1;
+  }
+  check(hilbert, "consecutive Hilbert cells are adjacent");
+
+  Grid grid = kuhn_grid(6, 0.2, true, 6);
+  Mesh mesh{grid.vcl, Connectivity{grid.til}, grid.sml};
+  size_t n_verts = grid.vcl.size(), n_tets = grid.til.size();
+
+  auto bandwidth = [](const Mesh &m) {
+    size_t width = 0;
+    for (size_t t = 0; t < m.til().size(); ++t) {
+      auto vertices = m.til()[t];
+      width = std::max(width, *std::max_element(vertices.begin(), vertices.end())
+          - *std::min_element(vertices.begin(), vertices.end()));
+    }
+    return width;
+  };
+
+  for (auto ordering : {Ordering::Morton, Ordering::Hilbert, Ordering::ReverseCuthillMcKee}) {
+
+    std::string name = std::to_string((int) ordering);
+    Mesh renumbered = mesh.permuted(mesh.order(ordering));
+
+    std::vector<size_t> vertex_order(renumbered.vertex_order().begin(), renumbered.vertex_order().end());
+    std::vector<size_t> tet_order(renumbered.tet_order().begin(), renumbered.tet_order().end());
+    std::sort(vertex_order.begin(), vertex_order.end());
+    std::sort(tet_order.begin(), tet_order.end());
+    std::vector<size_t> identity(std::max(n_verts, n_tets));
+    std::iota(identity.begin(), identity.end(), 0);
+
+    check(std::equal(vertex_order.begin(), vertex_order.end(), identity.begin()) && vertex_order.size() == n_verts,
+          "ordering " + name + " permutes the vertices");
+    check(std::equal(tet_order.begin(), tet_order.end(), identity.begin()) && tet_order.size() == n_tets,
+          "ordering " + name + " permutes the tetrahedra");
+
+    bool same = true;
+    for (size_t t = 0; t < n_tets; ++t) {
+      size_t old = renumbered.tet_order()[t];
+      same = same && renumbered.sml()[t] == grid.sml[old];
+      for (size_t c = 0; c < 4; ++c) {
+        same = same && renumbered.vcl()[renumbered.til()[t][c]] == grid.vcl[grid.til[old][c]];
+      }
+    }
+    check(same, "ordering " + name + " keeps the tetrahedra and sub-meshes");
+
+    if (ordering == Ordering::ReverseCuthillMcKee) {
+      check(bandwidth(renumbered) < bandwidth(mesh) / 4, "reverse Cuthill-McKee reduces the bandwidth");
+    }
+
+  }
+
+}
+
+//---------------------------------------------------------------------------//
+// Sub-meshes.                                                               //
+//---------------------------------------------------------------------------//
+
+/**
+ * Compare the sub-mesh partition with a map from sub-mesh to tetrahedra.
+ */
+void
+test_submeshes() {
+
+  std::mt19937_64 rng{9};
+  const std::vector<size_t> ids{0, 3, 4, 17, size_t{1} << 40};
+  std::uniform_int_distribution<size_t> pick{0, ids.size() - 1};
+
+  sm_list sml(5000);
+  for (auto &id : sml) id = ids[pick(rng)];
+
+  std::map<size_t, std::vector<size_t>> expected;
+  for (size_t t = 0; t < sml.size(); ++t) expected[sml[t]].push_back(t);
+
+  SubMeshes submeshes{sml};
+  check(submeshes.size() == expected.size(), "there is one sub-mesh per sub-mesh id");
+
+  bool same = submeshes.size() == expected.size();
+  size_t index = 0;
+  for (const auto &[id, tets] : expected) {
+    if (!same) break;
+    auto view = submeshes[index];
+    same = view.id == id && submeshes.index_of(id) == index
+        && std::equal(view.tets.begin(), view.tets.end(), tets.begin(), tets.end());
+    ++index;
+  }
+  check(same, "each sub-mesh holds its tetrahedra in ascending order");
+  check(!submeshes.index_of(5).has_value(), "an unused sub-mesh id has no sub-mesh");
+  check(SubMeshes{sm_list{}}.size() == 0, "an empty mesh has no sub-meshes");
+
+}
+
+//---------------------------------------------------------------------------//
+// Curl.                                                                     //
+//---------------------------------------------------------------------------//
+
+/**
+ * Compare the curl operator with the mean of the curls of the tetrahedra
+ * around each vertex, and with the exact curl of a linear field.
+ */
+void
+test_curl() {
+
+  Grid grid = kuhn_grid(5, 0.2, true, 7);
+  Mesh mesh{grid.vcl, Connectivity{grid.til}, grid.sml};
+  size_t n_verts = grid.vcl.size();
+
+  auto cross = [](const vert &a, const vert &b) {
+    return vert{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+  };
+
+  fv_list smooth(n_verts), linear(n_verts);
+  vert axis{0.3, -0.2, 0.5};
+  for (size_t i = 0; i < n_verts; ++i) {
+    const auto &r = grid.vcl[i];
+    smooth[i] = {(field_scalar) std::sin(0.3 * r[1]), (field_scalar) std::cos(0.2 * r[2] * r[0]),
+                 (field_scalar) (0.05 * r[0] * r[1])};
+    vert m = cross(axis, r);
+    linear[i] = {(field_scalar) m[0], (field_scalar) m[1], (field_scalar) m[2]};
+  }
+
+  Field smooth_field{"smooth", smooth}, linear_field{"linear", linear};
+  CurlOperator::Scratch scratch;
+  fv_list curl;
+
+  // Reference, the mean over the tetrahedra at each vertex of the curl of
+  // the field's linear interpolation.
+  std::vector<vert> reference(n_verts, vert{0, 0, 0});
+  std::vector<size_t> count(n_verts, 0);
+  for (const auto &t : grid.til) {
+    vert e1, e2, e3;
+    for (size_t c = 0; c < 3; ++c) {
+      e1[c] = grid.vcl[t[1]][c] - grid.vcl[t[0]][c];
+      e2[c] = grid.vcl[t[2]][c] - grid.vcl[t[0]][c];
+      e3[c] = grid.vcl[t[3]][c] - grid.vcl[t[0]][c];
+    }
+    std::array<vert, 3> rows{cross(e2, e3), cross(e3, e1), cross(e1, e2)};
+    double det = e1[0] * rows[0][0] + e1[1] * rows[0][1] + e1[2] * rows[0][2];
+    std::array<vert, 4> gradients;
+    for (size_t c = 0; c < 3; ++c) {
+      for (size_t k = 0; k < 3; ++k) gradients[k + 1][c] = rows[k][c] / det;
+      gradients[0][c] = -(gradients[1][c] + gradients[2][c] + gradients[3][c]);
+    }
+    vert tet_curl{0, 0, 0};
+    for (size_t k = 0; k < 4; ++k) {
+      const auto &m = smooth[t[k]];
+      vert c = cross(gradients[k], vert{m[0], m[1], m[2]});
+      for (size_t q = 0; q < 3; ++q) tet_curl[q] += c[q];
+    }
+    for (auto v : t) {
+      for (size_t q = 0; q < 3; ++q) reference[v][q] += tet_curl[q];
+      count[v]++;
+    }
+  }
+
+  mesh.curl(smooth_field, curl, scratch);
+  double error = 0.0, largest = 0.0;
+  for (size_t i = 0; i < n_verts; ++i) {
+    for (size_t q = 0; q < 3; ++q) {
+      double expected = reference[i][q] / (double) count[i];
+      largest = std::max(largest, std::abs(expected));
+      error = std::max(error, std::abs(expected - curl[i][q]));
+    }
+  }
+  check(error <= 1.0e-5 * largest, "curl matches the mean of the tetrahedra's curls");
+
+  mesh.curl(linear_field, curl, scratch);
+  error = 0.0;
+  for (size_t i = 0; i < n_verts; ++i) {
+    for (size_t q = 0; q < 3; ++q) error = std::max(error, std::abs(curl[i][q] - 2.0 * axis[q]));
+  }
+  check(error < 1.0e-4, "curl of a linear field is exact");
+
+}
+
+/**
+ * Apply the curl operator to batches of fields, including a partial batch,
+ * and compare with one field at a time.
+ */
+void
+test_batched_curl() {
+
+  Grid grid = kuhn_grid(4, 0.2, true, 11);
+  Mesh mesh{grid.vcl, Connectivity{grid.til}, grid.sml};
+
+  std::mt19937_64 rng{12};
+  std::uniform_real_distribution<double> unit{-1.0, 1.0};
+
+  std::vector<Field> fields;
+  for (size_t z = 0; z < 2 * CurlOperator::batch_size + 3; ++z) {
+    fv_list vectors(grid.vcl.size());
+    for (auto &v : vectors) v = {(field_scalar) unit(rng), (field_scalar) unit(rng), (field_scalar) unit(rng)};
+    fields.emplace_back("zone " + std::to_string(z), std::move(vectors));
+  }
+
+  std::vector<const Field *> pointers;
+  for (const auto &field : fields) pointers.push_back(&field);
+
+  CurlOperator::Scratch scratch;
+  std::vector<fv_list> curls(fields.size()), serial(fields.size());
+  mesh.curl(pointers, curls, scratch);
+  mesh.curl(pointers, serial, scratch, 1);
+
+  bool same = true;
+  fv_list curl;
+  for (size_t z = 0; z < fields.size(); ++z) {
+    mesh.curl(fields[z], curl, scratch);
+    same = same && curl == curls[z] && serial[z] == curls[z];
+  }
+  check(same, "batched curls match single curls");
+
+}
+
+}
+
+int
+main() {
+
+  try {
+
+    test_generator();
+    test_scanner();
+    test_mapped_read();
+    test_parallel_read();
+    test_lazy_fields();
+    test_model_cache();
+    test_hdf5();
+    test_binary_read();
+    test_octahedral();
+    test_surface_faces();
+    test_locator();
+    test_orderings();
+    test_submeshes();
+    test_curl();
+    test_batched_curl();
+
+  } catch (std::exception &e) {
+    std::cerr << "FAILED: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (n_failures > 0) {
+    std::cerr << n_failures << " check(s) failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "All tests passed." << std::endl;
+  return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,545 @@
+//
+// Created by Lesleis Nagy on 16/10/2026.
+//
+
+#ifndef MMPPT_TOY_QT_VTK_EX005_TOPOLOGY_HPP_
+#define MMPPT_TOY_QT_VTK_EX005_TOPOLOGY_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "aliases.hpp"
+#include "parallel.hpp"
+
+/**
+ * The unique faces and edges of a tetrahedral mesh and the adjacency between
+ * them and the tetrahedra.
+ *
+ * Every tetrahedron contributes four faces and six edges, each with its
+ * vertex indices sorted and packed in to an integer key. The keys are radix
+ * sorted, which brings copies of the same face or edge together, and each
+ * run of equal keys becomes one entity. Faces and edges are therefore
+ * numbered in order of their sorted vertex indices and the tetrahedra of an
+ * entity are in ascending order, the tables do not depend on the number of
+ * threads.
+ *
+ * Tables with a varying number of entries per row (the tetrahedra of a face
+ * or an edge) are stored in CSR form, an offsets array with one entry per
+ * row plus one and a flat array of values. Tables with a fixed number of
+ * entries per tetrahedron (faces, neighbours and edges) are flat arrays with
+ * a stride of four, four and six.
+ *
+ * Local face `f` of a tetrahedron is the face opposite its vertex `f`, and
+ * the neighbour across it is neighbour `f`.
+ *
+ * @tparam Id the integer type of vertex, face, edge and tetrahedron indices.
+ */
+template<typename Id>
+class BasicTopology {
+
+ public:
+
+  /**
+   * Marks a missing neighbour, i.e. a face on the boundary of the mesh.
+   */
+  static constexpr Id no_tet = std::numeric_limits<Id>::max();
+
+  /**
+   * The vertices of each local face, local face `f` leaves out vertex `f`.
+   */
+  static constexpr std::array<std::array<size_t, 3>, 4> local_faces{{
+      {1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}
+  }};
+
+  /**
+   * The vertices of each local edge.
+   */
+  static constexpr std::array<std::array<size_t, 2>, 6> local_edges{{
+      {0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}
+  }};
+
+  /**
+   * Check whether a mesh can be described with indices of type `Id`.
+   * @param n_verts the number of vertices.
+   * @param n_tets the number of tetrahedra.
+   * @return true if the indices fit, otherwise false.
+   */
+  [[nodiscard]] static constexpr bool
+  fits(size_t n_verts, size_t n_tets) {
+    constexpr auto max = (size_t) std::numeric_limits<Id>::max();
+    return n_verts <= max && n_tets <= max / local_edges.size();
+  }
+
+  /**
+   * Create an empty topology.
+   */
+  BasicTopology() = default;
+
+  /**
+   * Build the topology of a mesh.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   * @param n_verts the number of vertices, every index must be less than
+   *                this.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  template<typename Index>
+  BasicTopology(const basic_tet_list<Index> &til, size_t n_verts, size_t n_threads = 0) :
+      _n_tets{til.size()} {
+
+    if (!fits(n_verts, til.size())) {
+      throw std::length_error("Mesh is too large for the topology's index type.");
+    }
+
+    auto bits = (size_t) std::max<int>(std::bit_width(n_verts > 0 ? n_verts - 1 : 0), 1);
+
+    build<local_faces.size(), 3>(til, n_verts, bits, local_faces, _faces, _face_offsets, _face_tets,
+                                 _tet_faces, &_tet_neighbours, n_threads);
+    build<local_edges.size(), 2>(til, n_verts, bits, local_edges, _edges, _edge_offsets, _edge_tets,
+                                 _tet_edges, nullptr, n_threads);
+
+  }
+
+  /**
+   * Retrieve the number of tetrahedra.
+   * @return the number of tetrahedra.
+   */
+  [[nodiscard]] size_t
+  n_tets() const { return _n_tets; }
+
+  /**
+   * Retrieve the number of unique faces.
+   * @return the number of faces.
+   */
+  [[nodiscard]] size_t
+  n_faces() const { return _faces.size(); }
+
+  /**
+   * Retrieve the number of unique edges.
+   * @return the number of edges.
+   */
+  [[nodiscard]] size_t
+  n_edges() const { return _edges.size(); }
+
+  /**
+   * Retrieve the unique faces.
+   * @return the faces, each with its vertex indices in ascending order.
+   */
+  [[nodiscard]] const std::vector<basic_tri<Id>> &
+  faces() const { return _faces; }
+
+  /**
+   * Retrieve the CSR offsets of the face to tetrahedra table, the
+   * tetrahedra of face `f` are face_tets()[face_offsets()[f]] up to
+   * face_tets()[face_offsets()[f + 1]].
+   * @return the n_faces() + 1 offsets.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  face_offsets() const { return _face_offsets; }
+
+  /**
+   * Retrieve the CSR values of the face to tetrahedra table.
+   * @return the tetrahedra of every face.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  face_tets() const { return _face_tets; }
+
+  /**
+   * Retrieve the tetrahedra that share a face.
+   * @param face the face index.
+   * @return one tetrahedron for a boundary face, otherwise two.
+   */
+  [[nodiscard]] std::span<const Id>
+  face_tets(size_t face) const {
+    return {_face_tets.data() + _face_offsets[face], _face_tets.data() + _face_offsets[face + 1]};
+  }
+
+  /**
+   * Check whether a face is on the boundary of the mesh.
+   * @param face the face index.
+   * @return true if the face belongs to one tetrahedron, otherwise false.
+   */
+  [[nodiscard]] bool
+  is_boundary(size_t face) const {
+    return _face_offsets[face + 1] - _face_offsets[face] == 1;
+  }
+
+  /**
+   * Retrieve the face of every tetrahedron, four per tetrahedron.
+   * @return the tetrahedron to face table.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  tet_faces() const { return _tet_faces; }
+
+  /**
+   * Retrieve the faces of a tetrahedron.
+   * @param tet the tetrahedron index.
+   * @return the faces, face `f` is opposite vertex `f`.
+   */
+  [[nodiscard]] std::span<const Id, 4>
+  tet_faces(size_t tet) const { return std::span<const Id, 4>{_tet_faces.data() + 4 * tet, 4}; }
+
+  /**
+   * Retrieve the neighbours of every tetrahedron, four per tetrahedron.
+   * @return the tetrahedron to tetrahedra table.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  tet_neighbours() const { return _tet_neighbours; }
+
+  /**
+   * Retrieve the neighbours of a tetrahedron.
+   * @param tet the tetrahedron index.
+   * @return the neighbours, neighbour `f` shares face `f`, no_tet when the
+   *         face is on the boundary.
+   */
+  [[nodiscard]] std::span<const Id, 4>
+  tet_neighbours(size_t tet) const { return std::span<const Id, 4>{_tet_neighbours.data() + 4 * tet, 4}; }
+
+  /**
+   * Retrieve the unique edges.
+   * @return the edges, each with its vertex indices in ascending order.
+   */
+  [[nodiscard]] const std::vector<basic_edge<Id>> &
+  edges() const { return _edges; }
+
+  /**
+   * Retrieve the CSR offsets of the edge to tetrahedra table.
+   * @return the n_edges() + 1 offsets.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  edge_offsets() const { return _edge_offsets; }
+
+  /**
+   * Retrieve the CSR values of the edge to tetrahedra table.
+   * @return the tetrahedra of every edge.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  edge_tets() const { return _edge_tets; }
+
+  /**
+   * Retrieve the tetrahedra that share an edge.
+   * @param edge the edge index.
+   * @return the tetrahedra.
+   */
+  [[nodiscard]] std::span<const Id>
+  edge_tets(size_t edge) const {
+    return {_edge_tets.data() + _edge_offsets[edge], _edge_tets.data() + _edge_offsets[edge + 1]};
+  }
+
+  /**
+   * Retrieve the edges of every tetrahedron, six per tetrahedron.
+   * @return the tetrahedron to edge table.
+   */
+  [[nodiscard]] const std::vector<Id> &
+  tet_edges() const { return _tet_edges; }
+
+  /**
+   * Retrieve the edges of a tetrahedron.
+   * @param tet the tetrahedron index.
+   * @return the edges, in the order of local_edges.
+   */
+  [[nodiscard]] std::span<const Id, 6>
+  tet_edges(size_t tet) const { return std::span<const Id, 6>{_tet_edges.data() + 6 * tet, 6}; }
+
+  /**
+   * Find the faces that bound the mesh or separate two sub-meshes.
+   * @param sml the sub-mesh index of every tetrahedron.
+   * @return the faces, in ascending order.
+   */
+  [[nodiscard]] std::vector<Id>
+  surface_faces(const sm_list &sml) const {
+
+    if (sml.size() != _n_tets) {
+      throw std::invalid_argument("Sub-mesh list does not match the number of tetrahedra.");
+    }
+
+    std::vector<Id> faces;
+
+    for (size_t f = 0; f < n_faces(); ++f) {
+      auto tets = face_tets(f);
+      if (tets.size() != 2 || sml[tets[0]] != sml[tets[1]]) {
+        faces.push_back((Id) f);
+      }
+    }
+
+    return faces;
+
+  }
+
+  /**
+   * Find which local face of a tetrahedron a face is.
+   * @param tet the tetrahedron index.
+   * @param face the face index, this must be a face of the tetrahedron.
+   * @return the local face, i.e. the tetrahedron's vertex opposite the face.
+   */
+  [[nodiscard]] size_t
+  local_face(size_t tet, size_t face) const {
+    auto faces = tet_faces(tet);
+    return (size_t) (std::find(faces.begin(), faces.end(), (Id) face) - faces.begin());
+  }
+
+ private:
+
+  // A packed key and the (tetrahedron, local entity) it came from.
+  template<size_t Words>
+  struct Record {
+    std::array<uint64_t, Words> key;
+    Id item;
+  };
+
+  size_t _n_tets{0};
+
+  std::vector<basic_tri<Id>> _faces;
+  std::vector<Id> _face_offsets;
+  std::vector<Id> _face_tets;
+  std::vector<Id> _tet_faces;
+  std::vector<Id> _tet_neighbours;
+
+  std::vector<basic_edge<Id>> _edges;
+  std::vector<Id> _edge_offsets;
+  std::vector<Id> _edge_tets;
+  std::vector<Id> _tet_edges;
+
+  /**
+   * Build the entities of one kind, choosing the narrowest key that holds
+   * `Arity` vertex indices of `bits` bits.
+   */
+  template<size_t PerTet, size_t Arity, typename Index>
+  static void
+  build(const basic_tet_list<Index> &til, size_t n_verts, size_t bits,
+        const std::array<std::array<size_t, Arity>, PerTet> &local,
+        std::vector<std::array<Id, Arity>> &entities, std::vector<Id> &offsets,
+        std::vector<Id> &tets, std::vector<Id> &tet_entities, std::vector<Id> *neighbours,
+        size_t n_threads) {
+
+    size_t key_bits = Arity * bits;
+
+    if (key_bits <= 64) {
+      build_with_key<PerTet, Arity, 1>(til, n_verts, bits, local, entities, offsets, tets,
+                                       tet_entities, neighbours, n_threads);
+    } else if (key_bits <= 128) {
+      build_with_key<PerTet, Arity, 2>(til, n_verts, bits, local, entities, offsets, tets,
+                                       tet_entities, neighbours, n_threads);
+    } else {
+      build_with_key<PerTet, Arity, 3>(til, n_verts, bits, local, entities, offsets, tets,
+                                       tet_entities, neighbours, n_threads);
+    }
+
+  }
+
+  /**
+   * Build the entities of one kind: sort the packed keys of every local
+   * entity of every tetrahedron, number the runs of equal keys and fill in
+   * the tables. Faces also fill in the neighbours, the two tetrahedra of an
+   * interior face are each other's neighbours.
+   */
+  template<size_t PerTet, size_t Arity, size_t Words, typename Index>
+  static void
+  build_with_key(const basic_tet_list<Index> &til, size_t n_verts, size_t bits,
+        const std::array<std::array<size_t, Arity>, PerTet> &local,
+        std::vector<std::array<Id, Arity>> &entities, std::vector<Id> &offsets,
+        std::vector<Id> &tets, std::vector<Id> &tet_entities, std::vector<Id> *neighbours,
+        size_t n_threads) {
+
+    constexpr size_t grain = 1 << 14;
+
+    size_t n = til.size() * PerTet;
+
+    // The key of a record shifted right by `shift` bits.
+    auto key_bits = [](const Record<Words> &record, size_t shift) {
+      size_t word = shift / 64, offset = shift % 64;
+      uint64_t value = record.key[word] >> offset;
+      if (offset != 0 && word + 1 < Words) value |= record.key[word + 1] << (64 - offset);
+      return value;
+    };
+
+    // Pack the keys, vertex indices in ascending order with the smallest the
+    // most significant. Sorting a tetrahedron's vertices once sorts all of
+    // its faces and edges, taking the vertices of an entity in the order of
+    // the sorted tetrahedron.
+    std::vector<Record<Words>> records(n);
+
+    parallel_for_blocks(til.size(), grain, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; ++t) {
+
+        std::array<size_t, 4> corners{0, 1, 2, 3};
+        std::sort(corners.begin(), corners.end(), [&til, t](size_t a, size_t b) {
+          return til[t][a] < til[t][b];
+        });
+        if (til[t][corners[3]] >= n_verts) {
+          throw std::out_of_range("Tetrahedron vertex index is out of range.");
+        }
+
+        for (size_t l = 0; l < PerTet; ++l) {
+          unsigned members = 0;
+          for (size_t corner : local[l]) members |= 1u << corner;
+
+          auto &record = records[t * PerTet + l];
+          record.item = (Id) (t * PerTet + l);
+          size_t shift = Arity * bits;
+          for (size_t corner : corners) {
+            if (!(members & (1u << corner))) continue;
+            shift -= bits;
+            uint64_t v = til[t][corner];
+            size_t word = shift / 64, offset = shift % 64;
+            record.key[word] |= v << offset;
+            if (offset + bits > 64) record.key[word + 1] |= v >> (64 - offset);
+          }
+        }
+
+      }
+    }, n_threads);
+
+    parallel_radix_sort(records, Arity * bits, key_bits, n_threads);
+
+    // Count the runs of equal keys that start in each block, the running
+    // total gives the index of every block's first new entity.
+    size_t n_blocks = std::max<size_t>(std::min(4 * thread_count(n_threads), n / grain), 1);
+    size_t block_size = (n + n_blocks - 1) / n_blocks;
+
+    auto is_head = [&records](size_t i) {
+      return i == 0 || records[i].key != records[i - 1].key;
+    };
+
+    std::vector<size_t> first(n_blocks + 1, 0);
+    parallel_for(n_blocks, [&](size_t b) {
+      size_t count = 0;
+      for (size_t i = b * block_size, end = std::min(i + block_size, n); i < end; ++i) {
+        count += is_head(i);
+      }
+      first[b + 1] = count;
+    }, n_threads);
+    for (size_t b = 0; b < n_blocks; ++b) first[b + 1] += first[b];
+
+    size_t n_entities = first[n_blocks];
+    uint64_t vertex_mask = bits < 64 ? (uint64_t{1} << bits) - 1 : ~uint64_t{0};
+
+    entities.resize(n_entities);
+    offsets.resize(n_entities + 1);
+    tets.resize(n);
+    tet_entities.resize(n);
+
+    parallel_for(n_blocks, [&](size_t b) {
+      // The entity in progress, wraps to the first head of block zero.
+      size_t entity = first[b] - 1;
+      for (size_t i = b * block_size, end = std::min(i + block_size, n); i < end; ++i) {
+        size_t item = records[i].item;
+        if (is_head(i)) {
+          ++entity;
+          for (size_t k = 0; k < Arity; ++k) {
+            entities[entity][k] = (Id) (key_bits(records[i], (Arity - 1 - k) * bits) & vertex_mask);
+          }
+          offsets[entity] = (Id) i;
+        }
+        tets[i] = (Id) (item / PerTet);
+        tet_entities[item] = (Id) entity;
+      }
+    }, n_threads);
+    offsets[n_entities] = (Id) n;
+
+    if (neighbours == nullptr) return;
+
+    neighbours->resize(n);
+
+    parallel_for_blocks(n_entities, grain, [&](size_t begin, size_t end) {
+      for (size_t e = begin; e < end; ++e) {
+        size_t start = offsets[e], stop = offsets[e + 1];
+        if (stop - start == 2) {
+          (*neighbours)[records[start].item] = tets[start + 1];
+          (*neighbours)[records[start + 1].item] = tets[start];
+        } else {
+          // Boundary faces, and faces shared by more than two tetrahedra in
+          // a broken mesh, have no neighbour.
+          for (size_t i = start; i < stop; ++i) (*neighbours)[records[i].item] = no_tet;
+        }
+      }
+    }, n_threads);
+
+  }
+
+};
+
+/**
+ * The topology of a mesh, see BasicTopology. Indices are stored with 32 bits
+ * when the mesh is small enough, which covers every mesh that fits in
+ * memory today, and with 64 bits otherwise.
+ */
+class Topology {
+
+ public:
+
+  /**
+   * Create an empty topology.
+   */
+  Topology() = default;
+
+  /**
+   * Build the topology of a mesh.
+   * @param til the (t)etrahedra (i)ndex (l)ist.
+   * @param n_verts the number of vertices.
+   * @param n_threads the maximum number of threads, zero means one per core.
+   */
+  template<typename Index>
+  Topology(const basic_tet_list<Index> &til, size_t n_verts, size_t n_threads = 0) {
+    if (BasicTopology<uint32_t>::fits(n_verts, til.size())) {
+      _topology = BasicTopology<uint32_t>{til, n_verts, n_threads};
+    } else {
+      _topology = BasicTopology<size_t>{til, n_verts, n_threads};
+    }
+  }
+
+  /**
+   * Retrieve the number of tetrahedra.
+   * @return the number of tetrahedra.
+   */
+  [[nodiscard]] size_t
+  n_tets() const { return std::visit([](const auto &topology) { return topology.n_tets(); }, _topology); }
+
+  /**
+   * Retrieve the number of unique faces.
+   * @return the number of faces.
+   */
+  [[nodiscard]] size_t
+  n_faces() const { return std::visit([](const auto &topology) { return topology.n_faces(); }, _topology); }
+
+  /**
+   * Retrieve the number of unique edges.
+   * @return the number of edges.
+   */
+  [[nodiscard]] size_t
+  n_edges() const { return std::visit([](const auto &topology) { return topology.n_edges(); }, _topology); }
+
+  /**
+   * Retrieve the size of an index.
+   * @return the size of an index, 4 or 8 bytes.
+   */
+  [[nodiscard]] size_t
+  index_size() const {
+    return std::holds_alternative<BasicTopology<uint32_t>>(_topology) ? sizeof(uint32_t) : sizeof(size_t);
+  }
+
+  /**
+   * Call `fn` with the underlying BasicTopology<uint32_t> or
+   * BasicTopology<size_t>.
+   * @param fn the function.
+   * @return the result of the function.
+   */
+  template<typename Fn>
+  decltype(auto)
+  visit(Fn &&fn) const { return std::visit(std::forward<Fn>(fn), _topology); }
+
+ private:
+
+  std::variant<BasicTopology<uint32_t>, BasicTopology<size_t>> _topology;
+
+};
+
+#endif // MMPPT_TOY_QT_VTK_EX005_TOPOLOGY_HPP_